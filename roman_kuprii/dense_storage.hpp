@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace uni_cpp_practice {
+
+// Id -> value container for ids handed out sequentially from zero. Values
+// live in one contiguous vector indexed directly by id, while lookups and
+// iteration mirror the std::unordered_map interface.
+template <typename Id, typename T>
+class DenseStorage {
+ public:
+  class ConstIterator {
+   public:
+    ConstIterator(const T* data, Id id) : data_(data), id_(id) {}
+
+    std::pair<Id, const T&> operator*() const { return {id_, data_[id_]}; }
+    ConstIterator& operator++() {
+      ++id_;
+      return *this;
+    }
+    bool operator==(const ConstIterator& other) const {
+      return id_ == other.id_;
+    }
+    bool operator!=(const ConstIterator& other) const {
+      return id_ != other.id_;
+    }
+
+   private:
+    const T* data_ = nullptr;
+    Id id_;
+  };
+
+  template <typename... Args>
+  void emplace(const Id& id, Args&&... args) {
+    assert(id == static_cast<Id>(values_.size()));
+    values_.emplace_back(std::forward<Args>(args)...);
+  }
+
+  bool contains(const Id& id) const {
+    return id >= 0 && id < static_cast<Id>(values_.size());
+  }
+
+  T& at(const Id& id) {
+    if (!contains(id))
+      throw std::out_of_range("Id is out of range");
+    return values_[id];
+  }
+  const T& at(const Id& id) const {
+    if (!contains(id))
+      throw std::out_of_range("Id is out of range");
+    return values_[id];
+  }
+
+  ConstIterator begin() const { return ConstIterator(values_.data(), 0); }
+  ConstIterator end() const {
+    return ConstIterator(values_.data(), values_.size());
+  }
+
+  std::size_t size() const { return values_.size(); }
+  bool empty() const { return values_.empty(); }
+  void reserve(std::size_t capacity) { values_.reserve(capacity); }
+
+ private:
+  std::vector<T> values_;
+};
+
+}  // namespace uni_cpp_practice
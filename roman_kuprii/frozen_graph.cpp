@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <vector>
+
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+
+FrozenGraph::FrozenGraph(const Graph& graph) {
+  const int vertices_count = graph.get_vertices().size();
+  const int edges_count = graph.get_edges().size();
+
+  connected_vertices_.reserve(edges_count);
+  edge_colors_.reserve(edges_count);
+  for (EdgeId edge_id = 0; edge_id < edges_count; edge_id++) {
+    const auto& edge = graph.get_edges().at(edge_id);
+    connected_vertices_.push_back(edge.connected_vertices);
+    edge_colors_.push_back(edge.color);
+  }
+
+  depths_.reserve(vertices_count);
+  neighbor_offsets_.reserve(vertices_count + 1);
+  neighbor_ids_.reserve(edges_count);
+  neighbor_edge_ids_.reserve(edges_count);
+  neighbor_colors_.reserve(edges_count);
+  edge_offsets_.reserve(vertices_count + 1);
+  edge_ids_.reserve(2 * edges_count);
+
+  neighbor_offsets_.push_back(0);
+  edge_offsets_.push_back(0);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++) {
+    const auto& vertex = graph.get_vertices().at(vertex_id);
+    depths_.push_back(vertex.depth);
+    for (const auto& edge_id : vertex.get_edges_ids()) {
+      edge_ids_.push_back(edge_id);
+      const auto& connected_vertices = connected_vertices_[edge_id];
+      if (connected_vertices[0] == vertex_id) {
+        neighbor_ids_.push_back(connected_vertices[1]);
+        neighbor_edge_ids_.push_back(edge_id);
+        neighbor_colors_.push_back(edge_colors_[edge_id]);
+      }
+    }
+    neighbor_offsets_.push_back(neighbor_ids_.size());
+    edge_offsets_.push_back(edge_ids_.size());
+  }
+
+  for (const auto& connected_vertices : connected_vertices_)
+    max_depth_step_ =
+        std::max(max_depth_step_, depths_[connected_vertices[1]] -
+                                      depths_[connected_vertices[0]]);
+
+  // Counting sort of the edges by their destination.
+  predecessor_offsets_.assign(vertices_count + 1, 0);
+  for (const auto& connected_vertices : connected_vertices_)
+    predecessor_offsets_[connected_vertices[1] + 1]++;
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++)
+    predecessor_offsets_[vertex_id + 1] += predecessor_offsets_[vertex_id];
+  predecessor_ids_.resize(edges_count);
+  std::vector<int> predecessor_positions(predecessor_offsets_.begin(),
+                                         predecessor_offsets_.end() - 1);
+  for (const auto& connected_vertices : connected_vertices_)
+    predecessor_ids_[predecessor_positions[connected_vertices[1]]++] =
+        connected_vertices[0];
+
+  const int depth = graph.get_depth();
+  depth_offsets_.reserve(depth + 2);
+  depth_vertex_ids_.reserve(vertices_count);
+  depth_offsets_.push_back(0);
+  for (int current_depth = 0; current_depth <= depth; current_depth++) {
+    const auto& vertex_ids = graph.get_vertex_ids_at_depth(current_depth);
+    depth_vertex_ids_.insert(depth_vertex_ids_.end(), vertex_ids.begin(),
+                             vertex_ids.end());
+    depth_offsets_.push_back(depth_vertex_ids_.size());
+  }
+}
+
+ArrayView<VertexId> FrozenGraph::get_vertex_ids_at_depth(int depth) const {
+  assert(depth >= 0 && depth <= get_depth());
+  return ArrayView<VertexId>(
+      depth_vertex_ids_.data() + depth_offsets_[depth],
+      depth_offsets_[depth + 1] - depth_offsets_[depth]);
+}
+
+ArrayView<VertexId> FrozenGraph::get_neighbor_ids(
+    const VertexId& vertex_id) const {
+  assert(is_vertex_exist(vertex_id));
+  return ArrayView<VertexId>(
+      neighbor_ids_.data() + neighbor_offsets_[vertex_id],
+      neighbor_offsets_[vertex_id + 1] - neighbor_offsets_[vertex_id]);
+}
+
+ArrayView<EdgeId> FrozenGraph::get_neighbor_edge_ids(
+    const VertexId& vertex_id) const {
+  assert(is_vertex_exist(vertex_id));
+  return ArrayView<EdgeId>(
+      neighbor_edge_ids_.data() + neighbor_offsets_[vertex_id],
+      neighbor_offsets_[vertex_id + 1] - neighbor_offsets_[vertex_id]);
+}
+
+ArrayView<Edge::Color> FrozenGraph::get_neighbor_colors(
+    const VertexId& vertex_id) const {
+  assert(is_vertex_exist(vertex_id));
+  return ArrayView<Edge::Color>(
+      neighbor_colors_.data() + neighbor_offsets_[vertex_id],
+      neighbor_offsets_[vertex_id + 1] - neighbor_offsets_[vertex_id]);
+}
+
+ArrayView<VertexId> FrozenGraph::get_predecessor_ids(
+    const VertexId& vertex_id) const {
+  assert(is_vertex_exist(vertex_id));
+  return ArrayView<VertexId>(
+      predecessor_ids_.data() + predecessor_offsets_[vertex_id],
+      predecessor_offsets_[vertex_id + 1] - predecessor_offsets_[vertex_id]);
+}
+
+ArrayView<EdgeId> FrozenGraph::get_edge_ids(const VertexId& vertex_id) const {
+  assert(is_vertex_exist(vertex_id));
+  return ArrayView<EdgeId>(
+      edge_ids_.data() + edge_offsets_[vertex_id],
+      edge_offsets_[vertex_id + 1] - edge_offsets_[vertex_id]);
+}
+
+std::vector<EdgeId> FrozenGraph::get_edge_ids_with_color(
+    const Edge::Color& color) const {
+  std::vector<EdgeId> edge_ids;
+  for (EdgeId edge_id = 0; edge_id < get_edges_count(); edge_id++)
+    if (edge_colors_[edge_id] == color)
+      edge_ids.push_back(edge_id);
+  return edge_ids;
+}
+
+}  // namespace uni_cpp_practice
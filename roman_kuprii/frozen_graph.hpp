@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+
+template <typename T>
+class ArrayView {
+ public:
+  ArrayView(const T* data, std::size_t size) : data_(data), size_(size) {}
+
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const T& operator[](std::size_t index) const { return data_[index]; }
+
+ private:
+  const T* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+// Immutable compressed sparse row snapshot of a Graph. Vertex and edge ids
+// are sequential, so every attribute lives in a flat array indexed by id.
+// Nothing is mutated after construction, so a snapshot can be shared
+// between threads without locking.
+class FrozenGraph {
+ public:
+  explicit FrozenGraph(const Graph& graph);
+
+  int get_vertices_count() const { return depths_.size(); }
+  int get_edges_count() const { return connected_vertices_.size(); }
+  int get_depth() const { return depth_offsets_.size() - 2; }
+
+  bool is_vertex_exist(const VertexId& vertex_id) const {
+    return vertex_id >= 0 && vertex_id < get_vertices_count();
+  }
+
+  int get_vertex_depth(const VertexId& vertex_id) const {
+    return depths_[vertex_id];
+  }
+  ArrayView<VertexId> get_vertex_ids_at_depth(int depth) const;
+
+  // Largest depth increase along a single edge, zero without edges.
+  int get_max_depth_step() const { return max_depth_step_; }
+
+  // Destinations of the edges going out of the vertex, with ids and colors
+  // of those edges stored in parallel arrays.
+  ArrayView<VertexId> get_neighbor_ids(const VertexId& vertex_id) const;
+  ArrayView<EdgeId> get_neighbor_edge_ids(const VertexId& vertex_id) const;
+  ArrayView<Edge::Color> get_neighbor_colors(const VertexId& vertex_id) const;
+
+  // Sources of the edges coming into the vertex, ordered by edge id.
+  ArrayView<VertexId> get_predecessor_ids(const VertexId& vertex_id) const;
+
+  // All edges incident to the vertex, in the order they were added.
+  ArrayView<EdgeId> get_edge_ids(const VertexId& vertex_id) const;
+
+  const std::array<VertexId, 2>& get_connected_vertices(
+      const EdgeId& edge_id) const {
+    return connected_vertices_[edge_id];
+  }
+  Edge::Color get_edge_color(const EdgeId& edge_id) const {
+    return edge_colors_[edge_id];
+  }
+
+  std::vector<EdgeId> get_edge_ids_with_color(const Edge::Color& color) const;
+
+ private:
+  std::vector<int> depths_;
+  int max_depth_step_ = 0;
+  std::vector<int> depth_offsets_;
+  std::vector<VertexId> depth_vertex_ids_;
+
+  std::vector<int> neighbor_offsets_;
+  std::vector<VertexId> neighbor_ids_;
+  std::vector<EdgeId> neighbor_edge_ids_;
+  std::vector<Edge::Color> neighbor_colors_;
+
+  std::vector<int> predecessor_offsets_;
+  std::vector<VertexId> predecessor_ids_;
+
+  std::vector<int> edge_offsets_;
+  std::vector<EdgeId> edge_ids_;
+
+  std::vector<std::array<VertexId, 2>> connected_vertices_;
+  std::vector<Edge::Color> edge_colors_;
+};
+
+}  // namespace uni_cpp_practice
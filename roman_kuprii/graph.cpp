@@ -1,9 +1,13 @@
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 
 namespace {
@@ -37,6 +41,28 @@ uni_cpp_practice::Edge::Color calculate_edge_color(
   throw std::logic_error("Cant calculate color");
 }
 
+constexpr std::size_t MIN_CAPACITY = 16;
+
+std::uint64_t pack(const uni_cpp_practice::VertexId& first_vertex_id,
+                   const uni_cpp_practice::VertexId& second_vertex_id) {
+  assert(first_vertex_id >= 0 && second_vertex_id >= 0);
+  const auto low = static_cast<std::uint64_t>(
+      std::min(first_vertex_id, second_vertex_id));
+  const auto high = static_cast<std::uint64_t>(
+      std::max(first_vertex_id, second_vertex_id));
+  return (low << 32) | high;
+}
+
+// splitmix64 finalizer, spreads sequential ids over the whole table.
+std::uint64_t hash(std::uint64_t key) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  return key;
+}
+
 using std::min;
 using std::to_string;
 using std::vector;
@@ -45,6 +71,53 @@ using std::vector;
 
 namespace uni_cpp_practice {
 
+std::size_t ConnectionSet::find_slot(std::uint64_t key) const {
+  const std::size_t mask = slots_.size() - 1;
+  std::size_t slot = hash(key) & mask;
+  while (slots_[slot] != EMPTY_KEY && slots_[slot] != key)
+    slot = (slot + 1) & mask;
+  return slot;
+}
+
+void ConnectionSet::insert(const VertexId& first_vertex_id,
+                           const VertexId& second_vertex_id) {
+  // Keep the load factor at or below one half.
+  if (2 * (size_ + 1) > slots_.size())
+    rehash(std::max(MIN_CAPACITY, 2 * slots_.size()));
+
+  const auto key = pack(first_vertex_id, second_vertex_id);
+  const auto slot = find_slot(key);
+  if (slots_[slot] == EMPTY_KEY) {
+    slots_[slot] = key;
+    size_++;
+  }
+}
+
+bool ConnectionSet::contains(const VertexId& first_vertex_id,
+                             const VertexId& second_vertex_id) const {
+  if (slots_.empty())
+    return false;
+  const auto key = pack(first_vertex_id, second_vertex_id);
+  return slots_[find_slot(key)] == key;
+}
+
+void ConnectionSet::reserve(std::size_t count) {
+  std::size_t capacity = MIN_CAPACITY;
+  while (capacity < 2 * count)
+    capacity *= 2;
+  if (capacity > slots_.size())
+    rehash(capacity);
+}
+
+void ConnectionSet::rehash(std::size_t capacity) {
+  assert((capacity & (capacity - 1)) == 0);
+  auto old_slots = std::exchange(
+      slots_, std::vector<std::uint64_t>(capacity, EMPTY_KEY));
+  for (const auto& key : old_slots)
+    if (key != EMPTY_KEY)
+      slots_[find_slot(key)] = key;
+}
+
 void Vertex::add_edge_id(const EdgeId& _id) {
   assert(!is_edge_id_included(_id, edges_ids_));
   edges_ids_.push_back(_id);
@@ -60,8 +133,31 @@ VertexId Graph::add_vertex() {
   return new_vertex_id;
 }
 
+VertexId Graph::add_child_vertices(
+    const std::vector<VertexId>& parent_vertex_ids) {
+  const VertexId first_vertex_id = vertex_id_counter_;
+  for (const auto& parent_vertex_id : parent_vertex_ids) {
+    assert(is_vertex_exist(parent_vertex_id));
+    const VertexId new_vertex_id = get_next_vertex_id();
+    vertices_.emplace(new_vertex_id, new_vertex_id);
+    const int new_depth = vertices_.at(parent_vertex_id).depth + 1;
+    vertices_.at(new_vertex_id).depth = new_depth;
+    if (new_depth == static_cast<int>(depth_map_.size()))
+      depth_map_.emplace_back();
+    depth_map_[new_depth].push_back(new_vertex_id);
+
+    const auto new_edge_id = get_next_edge_id();
+    edges_.emplace(new_edge_id, Edge(parent_vertex_id, new_vertex_id,
+                                     new_edge_id, Edge::Color::Gray));
+    connections_.insert(parent_vertex_id, new_vertex_id);
+    vertices_.at(parent_vertex_id).add_edge_id(new_edge_id);
+    vertices_.at(new_vertex_id).add_edge_id(new_edge_id);
+  }
+  return first_vertex_id;
+}
+
 bool Graph::is_vertex_exist(const VertexId& vertex_id) const {
-  return vertices_.find(vertex_id) != vertices_.end();
+  return vertices_.contains(vertex_id);
 }
 
 bool Graph::is_connected(const VertexId& from_vertex_id,
@@ -69,21 +165,7 @@ bool Graph::is_connected(const VertexId& from_vertex_id,
   assert(is_vertex_exist(from_vertex_id));
   assert(is_vertex_exist(to_vertex_id));
 
-  const auto& from_vertex_edges_ids =
-      vertices_.at(from_vertex_id).get_edges_ids();
-  const auto& to_vertex_edges_ids = vertices_.at(to_vertex_id).get_edges_ids();
-  for (const auto& from_vertex_edge_id : from_vertex_edges_ids)
-    if (from_vertex_id == to_vertex_id) {
-      const auto& connected_vertices =
-          edges_.at(from_vertex_edge_id).connected_vertices;
-      if (connected_vertices[0] == connected_vertices[1])
-        return true;
-    } else
-      for (const auto& to_vertex_edge_id : to_vertex_edges_ids)
-        if (from_vertex_edge_id == to_vertex_edge_id)
-          return true;
-
-  return false;
+  return connections_.contains(from_vertex_id, to_vertex_id);
 }
 
 void Graph::connect_vertices(const VertexId& from_vertex_id,
@@ -115,6 +197,7 @@ void Graph::connect_vertices(const VertexId& from_vertex_id,
   edges_.emplace(new_edge_id,
                  Edge(from_vertex_id, to_vertex_id, new_edge_id, color));
 
+  connections_.insert(from_vertex_id, to_vertex_id);
   vertices_.at(from_vertex_id).add_edge_id(new_edge_id);
   if (from_vertex_id != to_vertex_id)
     vertices_.at(to_vertex_id).add_edge_id(new_edge_id);
@@ -131,6 +214,16 @@ std::vector<EdgeId> Graph::get_edge_ids_with_color(
   return edge_ids;
 }
 
+void Graph::reserve(int vertices_count, int edges_count) {
+  vertices_.reserve(vertices_count);
+  edges_.reserve(edges_count);
+  connections_.reserve(edges_count);
+}
+
+FrozenGraph Graph::freeze() const {
+  return FrozenGraph(*this);
+}
+
 const std::vector<VertexId>& Graph::get_vertex_ids_at_depth(int depth) const {
   assert(depth <= depth_map_.size());
   return depth_map_[depth];
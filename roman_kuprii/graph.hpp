@@ -2,10 +2,13 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
+#include "dense_storage.hpp"
+
 namespace uni_cpp_practice {
 
 using EdgeId = int;
@@ -13,8 +16,11 @@ using VertexId = int;
 
 constexpr int INVALID_ID = -1;
 
+class FrozenGraph;
+
 struct Edge {
   enum class Color { Gray, Green, Blue, Yellow, Red };
+  static constexpr int COLORS_COUNT = 5;
 
   const EdgeId id = INVALID_ID;
   const std::array<VertexId, 2> connected_vertices;
@@ -44,10 +50,48 @@ struct Vertex {
   std::vector<EdgeId> edges_ids_;
 };
 
+// Flat open-addressing hash set of connected vertex pairs. A pair is packed
+// into one 64-bit key with the smaller id in the high half, so (a, b) and
+// (b, a) are the same connection, as Graph::is_connected expects.
+class ConnectionSet {
+ public:
+  void insert(const VertexId& first_vertex_id,
+              const VertexId& second_vertex_id);
+
+  bool contains(const VertexId& first_vertex_id,
+                const VertexId& second_vertex_id) const;
+
+  void reserve(std::size_t count);
+
+  std::size_t size() const { return size_; }
+
+ private:
+  // Ids are never negative, so no packed pair can be all ones.
+  static constexpr std::uint64_t EMPTY_KEY = ~std::uint64_t(0);
+
+  std::vector<std::uint64_t> slots_;
+  std::size_t size_ = 0;
+
+  std::size_t find_slot(std::uint64_t key) const;
+  void rehash(std::size_t capacity);
+};
+
 class Graph {
  public:
+  Graph() = default;
+  // Graphs are moved from the generator to their consumer, never copied.
+  Graph(const Graph&) = delete;
+  Graph& operator=(const Graph&) = delete;
+  Graph(Graph&&) = default;
+  Graph& operator=(Graph&&) = default;
+
   VertexId add_vertex();
 
+  // Adds one new vertex under every listed parent, in order, connected to
+  // it with a gray edge. The new ids are sequential starting from the
+  // returned one.
+  VertexId add_child_vertices(const std::vector<VertexId>& parent_vertex_ids);
+
   bool is_vertex_exist(const VertexId& vertex_id) const;
 
   bool is_connected(const VertexId& from_vertex_id,
@@ -56,8 +100,8 @@ class Graph {
   void connect_vertices(const VertexId& from_vertex_id,
                         const VertexId& to_vertex_id);
 
-  const std::unordered_map<EdgeId, Edge>& get_edges() const { return edges_; }
-  const std::unordered_map<VertexId, Vertex>& get_vertices() const {
+  const DenseStorage<EdgeId, Edge>& get_edges() const { return edges_; }
+  const DenseStorage<VertexId, Vertex>& get_vertices() const {
     return vertices_;
   }
   const std::vector<VertexId>& get_vertex_ids_at_depth(int depth) const;
@@ -66,9 +110,14 @@ class Graph {
 
   std::vector<EdgeId> get_edge_ids_with_color(const Edge::Color& color) const;
 
+  void reserve(int vertices_count, int edges_count);
+
+  FrozenGraph freeze() const;
+
  private:
-  std::unordered_map<VertexId, Vertex> vertices_;
-  std::unordered_map<EdgeId, Edge> edges_;
+  DenseStorage<VertexId, Vertex> vertices_;
+  DenseStorage<EdgeId, Edge> edges_;
+  ConnectionSet connections_;
   std::vector<std::vector<VertexId>> depth_map_;
   VertexId vertex_id_counter_ = 0;
   EdgeId edge_id_counter_ = 0;
@@ -1,14 +1,15 @@
+#include <atomic>
+#include <cassert>
 #include <functional>
-#include <list>
 #include <mutex>
 #include <optional>
-#include <random>
-#include <thread>
-#include <vector>
+#include <utility>
 
 #include "graph.hpp"
 #include "graph_generation_controller.hpp"
 #include "graph_generator.hpp"
+#include "random_generator.hpp"
+#include "thread_pool.hpp"
 
 namespace uni_cpp_practice {
 
@@ -17,91 +18,80 @@ namespace graph_generation_controller {
 GraphGenerationController::GraphGenerationController(
     int threads_count,
     int graphs_count,
-    const GraphGenerator::Params& graph_generator_params)
-    : graphs_count_(graphs_count), graph_generator_(graph_generator_params) {
-  for (int iter = 0; iter < threads_count; iter++) {
-    workers_.emplace_back(
-        [&jobs_ = jobs_,
-         &get_job_mutex_ = get_job_mutex_]() -> std::optional<JobCallback> {
-          const std::lock_guard lock(get_job_mutex_);
-          if (jobs_.empty()) {
-            return std::nullopt;
-          }
-          const auto job = jobs_.front();
-          jobs_.pop_front();
-          return job;
-        });
-  }
+    const GraphGenerator::Params& graph_generator_params,
+    std::optional<int> max_unreleased_graphs)
+    : threads_count_(threads_count),
+      graphs_count_(graphs_count),
+      max_unreleased_graphs_(max_unreleased_graphs),
+      graph_generator_params_(graph_generator_params) {
+  assert(!max_unreleased_graphs_.has_value() ||
+         max_unreleased_graphs_.value() > 0);
 }
 
 void GraphGenerationController::generate(
     const GenStartedCallback& gen_started_callback,
     const GenFinishedCallback& gen_finished_callback) {
-  std::atomic<int> completed_jobs = 0;
-
-  for (auto& worker : workers_) {
-    worker.start();
+  gen_started_callback_ = gen_started_callback;
+  gen_finished_callback_ = gen_finished_callback;
+  {
+    const std::lock_guard lock(schedule_mutex_);
+    next_graph_index_ = 0;
+    running_graphs_count_ = 0;
+    unreleased_graphs_count_ = 0;
   }
+  generated_graphs_count_ = 0;
 
-  {
-    std::lock_guard lock(get_job_mutex_);
-    for (int i = 0; i < graphs_count_; i++) {
-      jobs_.emplace_back([&gen_started_callback = gen_started_callback,
-                          &gen_finished_callback = gen_finished_callback, i,
-                          &finish_callback_mutex_ = finish_callback_mutex_,
-                          &start_callback_mutex_ = start_callback_mutex_,
-                          &graph_generator_ = graph_generator_,
-                          &completed_jobs = completed_jobs]() {
-        {
-          const std::lock_guard lock(start_callback_mutex_);
-          gen_started_callback(i);
-        }
+  submit_next_graphs();
+  ThreadPool::get_thread_pool().wait_until(
+      [this]() { return generated_graphs_count_ == graphs_count_; });
+}
 
-        auto graph = graph_generator_.generate();
-        {
-          const std::lock_guard lock(finish_callback_mutex_);
-          gen_finished_callback(std::move(graph), i);
-        }
-        completed_jobs++;
-      });
-    }
-  }
-  while (completed_jobs != graphs_count_) {
+void GraphGenerationController::release_graph() {
+  if (!max_unreleased_graphs_.has_value())
+    return;
+  {
+    const std::lock_guard lock(schedule_mutex_);
+    unreleased_graphs_count_--;
   }
+  submit_next_graphs();
+}
 
-  for (auto& worker : workers_) {
-    worker.stop();
+void GraphGenerationController::generate_graph(int index) {
+  {
+    const std::lock_guard lock(start_callback_mutex_);
+    gen_started_callback_(index);
   }
-}
 
-GraphGenerationController::Worker::~Worker() {
-  if (state_ == State::Working)
-    stop();
-}
+  auto params = graph_generator_params_;
+  if (params.seed.has_value())
+    params.seed = derive_seed(params.seed.value(), index);
+  auto graph = GraphGenerator(params).generate();
+  {
+    const std::lock_guard lock(finish_callback_mutex_);
+    gen_finished_callback_(std::move(graph), index);
+  }
 
-void GraphGenerationController::Worker::start() {
-  assert(state_ != State::Working);
-  state_ = State::Working;
-  thread_ =
-      std::thread([&state_ = state_, &get_job_callback_ = get_job_callback_]() {
-        while (true) {
-          if (state_ == State::ShouldTerminate) {
-            state_ = State::Idle;
-            return;
-          }
-          const auto job_optional = get_job_callback_();
-          if (job_optional.has_value()) {
-            job_optional.value()();
-          }
-        }
-      });
+  {
+    const std::lock_guard lock(schedule_mutex_);
+    running_graphs_count_--;
+  }
+  submit_next_graphs();
+  generated_graphs_count_++;
 }
 
-void GraphGenerationController::Worker::stop() {
-  assert(state_ == State::Working);
-  state_ = State::ShouldTerminate;
-  if (thread_.joinable())
-    thread_.join();
+void GraphGenerationController::submit_next_graphs() {
+  const std::lock_guard lock(schedule_mutex_);
+  while (next_graph_index_ < graphs_count_ &&
+         running_graphs_count_ < threads_count_ &&
+         (!max_unreleased_graphs_.has_value() ||
+          unreleased_graphs_count_ < max_unreleased_graphs_.value())) {
+    const int index = next_graph_index_++;
+    running_graphs_count_++;
+    if (max_unreleased_graphs_.has_value())
+      unreleased_graphs_count_++;
+    ThreadPool::get_thread_pool().submit(
+        [this, index]() { generate_graph(index); });
+  }
 }
 
 }  // namespace graph_generation_controller
@@ -2,10 +2,8 @@
 
 #include <atomic>
 #include <functional>
-#include <list>
 #include <mutex>
 #include <optional>
-#include <thread>
 
 #include "graph_generator.hpp"
 
@@ -17,45 +15,48 @@ namespace graph_generation_controller {
 
 class GraphGenerationController {
  public:
-  using JobCallback = std::function<void()>;
-  using GetJobCallback = std::function<std::optional<JobCallback>()>;
   using GenStartedCallback = std::function<void(int)>;
+  // Receives the ownership of the generated graph.
   using GenFinishedCallback = std::function<void(Graph, int)>;
 
-  class Worker {
-   public:
-    explicit Worker(const GetJobCallback& get_job_callback)
-        : get_job_callback_(get_job_callback){};
-
-    enum class State { Idle, Working, ShouldTerminate };
-
-    void start();
-    void stop();
-
-    ~Worker();
-
-   private:
-    std::thread thread_;
-    GetJobCallback get_job_callback_;
-    std::atomic<State> state_ = State::Idle;
-  };
-
+  // A seed in |graph_generator_params| is the seed of the whole run: every
+  // graph gets its own one derived from it and its index.
+  // With |max_unreleased_graphs| set, a graph counts against the limit from
+  // the start of its generation until the consumer calls release_graph(),
+  // and no new graph starts while the limit is reached.
   GraphGenerationController(
       int threads_count,
       int graphs_count,
-      const GraphGenerator::Params& graph_generator_params);
+      const GraphGenerator::Params& graph_generator_params,
+      std::optional<int> max_unreleased_graphs = std::nullopt);
 
+  // Generates the graphs as jobs of the shared thread pool, at most
+  // threads_count of them at a time.
   void generate(const GenStartedCallback& gen_started_callback,
                 const GenFinishedCallback& gen_finished_callback);
 
+  // Marks one of the generated graphs as consumed.
+  void release_graph();
+
  private:
-  std::list<Worker> workers_;
-  std::list<JobCallback> jobs_;
+  int threads_count_;
   int graphs_count_;
-  GraphGenerator graph_generator_;
+  std::optional<int> max_unreleased_graphs_;
+  GraphGenerator::Params graph_generator_params_;
+  GenStartedCallback gen_started_callback_;
+  GenFinishedCallback gen_finished_callback_;
   std::mutex start_callback_mutex_;
   std::mutex finish_callback_mutex_;
-  std::mutex get_job_mutex_;
+
+  std::mutex schedule_mutex_;
+  int next_graph_index_ = 0;
+  int running_graphs_count_ = 0;
+  int unreleased_graphs_count_ = 0;
+  std::atomic<int> generated_graphs_count_ = 0;
+
+  void generate_graph(int index);
+  // Submits as many of the remaining graphs as the limits allow.
+  void submit_next_graphs();
 };
 
 }  // namespace graph_generation_controller
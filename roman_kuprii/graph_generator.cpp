@@ -1,152 +1,223 @@
-#include <atomic>
+#include <algorithm>
+#include <cstdint>
 #include <functional>
-#include <list>
 #include <mutex>
-#include <optional>
+#include <numeric>
 #include <random>
-#include <thread>
+#include <utility>
 #include <vector>
 
 #include "graph.hpp"
 #include "graph_generator.hpp"
+#include "random_generator.hpp"
+#include "thread_pool.hpp"
 
 namespace {
 
 double get_real_random_number() {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<> dis(0, 1);
-  return dis(gen);
-}
-
-int get_int_random_number(int upper_bound) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<> dis(0, upper_bound);
-  return dis(gen);
+  return uni_cpp_practice::RandomGenerator::get_thread_generator().get_real();
 }
 
 constexpr double GREEN_TRASHOULD = 0.1;
 constexpr double BLUE_TRASHOULD = 0.25;
 constexpr double RED_TRASHOULD = 0.33;
 
-constexpr int MAX_THREADS_COUNT = 4;
+// Random yellow candidates tried before falling back to a full layer scan.
+// Only gray children of a vertex are connected to it on the next layer, so
+// a rejection is rare unless the layer is tiny.
+constexpr int MAX_REJECTED_CANDIDATES = 8;
+
+// Smallest part of a layer worth handing to a separate thread.
+constexpr int MIN_LAYER_PART_SIZE = 4096;
+
+// Vertices, or adjacent pairs of a layer, examined by one painting job.
+// Fixed rather than derived from the threads count, so that the order of
+// committed edges stays the same on any machine.
+constexpr int PAINT_PART_SIZE = 4096;
+
+// Random streams derived from the generation seed. Painting jobs key their
+// stream by the part of the graph they handle (yellow by vertex), gray
+// branches of the depth first generation take one stream per branch of the
+// root starting from GRAY_STREAM.
+constexpr std::uint32_t BLUE_STREAM = 0;
+constexpr std::uint32_t GREEN_STREAM = 1;
+constexpr std::uint32_t RED_STREAM = 2;
+constexpr std::uint32_t YELLOW_STREAM = 3;
+constexpr std::uint32_t GRAY_STREAM = 4;
 
 using std::vector;
 
 using uni_cpp_practice::Edge;
+using uni_cpp_practice::get_next_success_index;
 using uni_cpp_practice::Graph;
 using uni_cpp_practice::INVALID_ID;
+using uni_cpp_practice::PhiloxGenerator;
+using uni_cpp_practice::RandomGenerator;
+using uni_cpp_practice::ThreadPool;
 using uni_cpp_practice::Vertex;
 using uni_cpp_practice::VertexId;
 
-void add_blue_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
-  const int graph_depth = work_graph.get_depth();
-  for (int current_depth = 1; current_depth <= graph_depth; current_depth++) {
-    const auto& vertex_ids_at_current_depth =
-        work_graph.get_vertex_ids_at_depth(current_depth);
-
-    std::array<VertexId, 2> adjacent_vertices = {INVALID_ID, INVALID_ID};
-    for (const auto& vertex_id : vertex_ids_at_current_depth) {
-      if (adjacent_vertices[0] == INVALID_ID) {
-        adjacent_vertices[0] = vertex_id;
-      } else if (adjacent_vertices[1] == INVALID_ID) {
-        adjacent_vertices[1] = vertex_id;
-        if (get_real_random_number() < BLUE_TRASHOULD) {
-          std::lock_guard lock(add_edge_mutex);
-          work_graph.connect_vertices(adjacent_vertices[0],
-                                      adjacent_vertices[1]);
-        }
-      } else {
-        adjacent_vertices[0] = adjacent_vertices[1];
-        adjacent_vertices[1] = vertex_id;
-        if (get_real_random_number() < BLUE_TRASHOULD) {
-          std::lock_guard lock(add_edge_mutex);
-          work_graph.connect_vertices(adjacent_vertices[0],
-                                      adjacent_vertices[1]);
-        }
-      }
-    }
-  }
+using EdgeCandidates = std::vector<std::pair<VertexId, VertexId>>;
+using PaintJob = std::function<void(EdgeCandidates&)>;
+
+// Pairs (index - 1, index) of adjacent vertices of the layer, for every
+// index in [begin, end).
+void collect_blue_edges(const Graph& work_graph,
+                        int depth,
+                        int begin,
+                        int end,
+                        std::uint64_t seed,
+                        EdgeCandidates& edges) {
+  const auto& vertex_ids = work_graph.get_vertex_ids_at_depth(depth);
+  const auto part_key = (static_cast<std::uint64_t>(depth) << 32) | begin;
+  auto random = PhiloxGenerator(seed, BLUE_STREAM, part_key);
+  for (int index = get_next_success_index(random, BLUE_TRASHOULD,
+                                          std::max(begin, 1), end);
+       index < end;
+       index = get_next_success_index(random, BLUE_TRASHOULD, index + 1, end))
+    edges.emplace_back(vertex_ids[index - 1], vertex_ids[index]);
 }
 
-void add_green_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
-  for (const auto& [vertex_id, vertex] : work_graph.get_vertices())
-    if (get_real_random_number() < GREEN_TRASHOULD) {
-      std::lock_guard lock(add_edge_mutex);
-      work_graph.connect_vertices(vertex_id, vertex_id);
-    }
+void collect_green_edges(VertexId begin,
+                         VertexId end,
+                         std::uint64_t seed,
+                         EdgeCandidates& edges) {
+  auto random = PhiloxGenerator(seed, GREEN_STREAM, begin);
+  for (VertexId vertex_id =
+           get_next_success_index(random, GREEN_TRASHOULD, begin, end);
+       vertex_id < end; vertex_id = get_next_success_index(
+                            random, GREEN_TRASHOULD, vertex_id + 1, end))
+    edges.emplace_back(vertex_id, vertex_id);
 }
 
-void add_red_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
+void collect_red_edges(const Graph& work_graph,
+                       VertexId begin,
+                       VertexId end,
+                       std::uint64_t seed,
+                       EdgeCandidates& edges) {
   const int graph_depth = work_graph.get_depth();
-  for (const auto& [start_vertex_id, start_vertex] :
-       work_graph.get_vertices()) {
-    if (get_real_random_number() < RED_TRASHOULD) {
-      if (start_vertex.depth + 2 <= graph_depth) {
-        const auto& red_vertices_ids =
-            work_graph.get_vertex_ids_at_depth(start_vertex.depth + 2);
-        if (red_vertices_ids.size() > 0) {
-          std::lock_guard lock(add_edge_mutex);
-          work_graph.connect_vertices(start_vertex_id,
-                                      red_vertices_ids[get_int_random_number(
-                                          red_vertices_ids.size() - 1)]);
-        }
-      }
+  auto random = PhiloxGenerator(seed, RED_STREAM, begin);
+  for (VertexId start_vertex_id =
+           get_next_success_index(random, RED_TRASHOULD, begin, end);
+       start_vertex_id < end; start_vertex_id = get_next_success_index(
+                                  random, RED_TRASHOULD, start_vertex_id + 1,
+                                  end)) {
+    const auto& start_vertex = work_graph.get_vertices().at(start_vertex_id);
+    if (start_vertex.depth + 2 <= graph_depth) {
+      const auto& red_vertices_ids =
+          work_graph.get_vertex_ids_at_depth(start_vertex.depth + 2);
+      if (red_vertices_ids.size() > 0)
+        edges.emplace_back(
+            start_vertex_id,
+            red_vertices_ids[random.get_int(red_vertices_ids.size() - 1)]);
     }
   }
 }
 
-void add_yellow_edges(Graph& work_graph, std::mutex& add_edge_mutex) {
+// Uniformly random vertex of |vertex_ids| not connected to |vertex_id|, or
+// INVALID_ID if there is none. Draws candidates and rejects connected ones
+// first, and only filters the whole layer if those keep getting rejected.
+VertexId pick_unconnected_vertex(const Graph& work_graph,
+                                 const VertexId& vertex_id,
+                                 const std::vector<VertexId>& vertex_ids,
+                                 PhiloxGenerator& random) {
+  if (vertex_ids.empty())
+    return INVALID_ID;
+
+  for (int attempt = 0; attempt < MAX_REJECTED_CANDIDATES; attempt++) {
+    const auto candidate_id = vertex_ids[random.get_int(vertex_ids.size() - 1)];
+    if (!work_graph.is_connected(vertex_id, candidate_id))
+      return candidate_id;
+  }
+
+  vector<VertexId> unconnected_vertex_ids;
+  for (const auto& candidate_id : vertex_ids)
+    if (!work_graph.is_connected(vertex_id, candidate_id))
+      unconnected_vertex_ids.push_back(candidate_id);
+  if (unconnected_vertex_ids.empty())
+    return INVALID_ID;
+  return unconnected_vertex_ids[random.get_int(unconnected_vertex_ids.size() -
+                                               1)];
+}
+
+void collect_yellow_edges(const Graph& work_graph,
+                          VertexId begin,
+                          VertexId end,
+                          std::uint64_t seed,
+                          EdgeCandidates& edges) {
   const int graph_depth = work_graph.get_depth();
-  for (const auto& [start_vertex_id, start_vertex] :
-       work_graph.get_vertices()) {
+  for (VertexId start_vertex_id = begin; start_vertex_id < end;
+       start_vertex_id++) {
+    const auto& start_vertex = work_graph.get_vertices().at(start_vertex_id);
+    auto random = PhiloxGenerator(seed, YELLOW_STREAM, start_vertex_id);
     const double probability = static_cast<double>(start_vertex.depth) /
                                static_cast<double>(graph_depth);
-    if (get_real_random_number() < probability) {
-      vector<VertexId> yellow_vertices_ids;
-      if (start_vertex.depth + 1 <= graph_depth) {
-        const auto& vertex_on_next_depth =
-            work_graph.get_vertex_ids_at_depth(start_vertex.depth + 1);
-        for (const auto& vertex_id : vertex_on_next_depth) {
-          const auto is_connected = [&work_graph, &add_edge_mutex,
-                                     &start_vertex_id = start_vertex_id,
-                                     &vertex_id]() {
-            const std::lock_guard lock(add_edge_mutex);
-            return work_graph.is_connected(start_vertex_id, vertex_id);
-          }();
-          if (!is_connected)
-            yellow_vertices_ids.push_back(vertex_id);
-        }
-        if (yellow_vertices_ids.size() > 0) {
-          std::lock_guard lock(add_edge_mutex);
-          work_graph.connect_vertices(start_vertex_id,
-                                      yellow_vertices_ids[get_int_random_number(
-                                          yellow_vertices_ids.size() - 1)]);
-        }
-      }
+    if (random.get_real() < probability &&
+        start_vertex.depth + 1 <= graph_depth) {
+      const auto yellow_vertex_id = pick_unconnected_vertex(
+          work_graph, start_vertex_id,
+          work_graph.get_vertex_ids_at_depth(start_vertex.depth + 1), random);
+      if (yellow_vertex_id != INVALID_ID)
+        edges.emplace_back(start_vertex_id, yellow_vertex_id);
     }
   }
 }
 
-void paint_edges(Graph& work_graph) {
-  std::mutex add_edges_mutex;
-  std::thread blue_thread([&work_graph, &add_edges_mutex]() {
-    add_blue_edges(work_graph, add_edges_mutex);
-  });
-  std::thread green_thread([&work_graph, &add_edges_mutex]() {
-    add_green_edges(work_graph, add_edges_mutex);
-  });
-  std::thread red_thread([&work_graph, &add_edges_mutex]() {
-    add_red_edges(work_graph, add_edges_mutex);
-  });
-  std::thread yellow_thread([&work_graph, &add_edges_mutex]() {
-    add_yellow_edges(work_graph, add_edges_mutex);
-  });
-  blue_thread.join();
-  green_thread.join();
-  red_thread.join();
-  yellow_thread.join();
+// Painting runs in two phases. First every job collects the edges of one
+// color over one part of the graph into its own buffer, all jobs in
+// parallel and without touching the graph. Then the buffers are committed
+// in job order, which keeps edge ids independent of the threads count.
+// None of the colors can produce an edge another one checks for, so the
+// jobs do not need to see each other's edges.
+void paint_edges(Graph& work_graph, std::uint64_t seed) {
+  const int vertices_count = work_graph.get_vertices().size();
+  const int graph_depth = work_graph.get_depth();
+  std::vector<PaintJob> jobs;
+
+  for (int depth = 1; depth <= graph_depth; depth++) {
+    const int layer_size = work_graph.get_vertex_ids_at_depth(depth).size();
+    for (int begin = 0; begin < layer_size; begin += PAINT_PART_SIZE) {
+      const int end = std::min(layer_size, begin + PAINT_PART_SIZE);
+      jobs.emplace_back([&work_graph, depth, begin, end,
+                         seed](EdgeCandidates& edges) {
+        collect_blue_edges(work_graph, depth, begin, end, seed, edges);
+      });
+    }
+  }
+  for (VertexId begin = 0; begin < vertices_count; begin += PAINT_PART_SIZE) {
+    const VertexId end = std::min(vertices_count, begin + PAINT_PART_SIZE);
+    jobs.emplace_back([begin, end, seed](EdgeCandidates& edges) {
+      collect_green_edges(begin, end, seed, edges);
+    });
+  }
+  for (VertexId begin = 0; begin < vertices_count; begin += PAINT_PART_SIZE) {
+    const VertexId end = std::min(vertices_count, begin + PAINT_PART_SIZE);
+    jobs.emplace_back([&work_graph, begin, end, seed](EdgeCandidates& edges) {
+      collect_red_edges(work_graph, begin, end, seed, edges);
+    });
+  }
+  for (VertexId begin = 0; begin < vertices_count; begin += PAINT_PART_SIZE) {
+    const VertexId end = std::min(vertices_count, begin + PAINT_PART_SIZE);
+    jobs.emplace_back([&work_graph, begin, end, seed](EdgeCandidates& edges) {
+      collect_yellow_edges(work_graph, begin, end, seed, edges);
+    });
+  }
+
+  std::vector<EdgeCandidates> jobs_edges(jobs.size());
+  ThreadPool::get_thread_pool().run_in_parallel(
+      jobs.size(), 1, [&jobs, &jobs_edges](int begin, int end) {
+        for (int index = begin; index < end; index++)
+          jobs[index](jobs_edges[index]);
+      });
+
+  int new_edges_count = 0;
+  for (const auto& edges : jobs_edges)
+    new_edges_count += edges.size();
+  work_graph.reserve(vertices_count,
+                     work_graph.get_edges().size() + new_edges_count);
+  for (const auto& edges : jobs_edges)
+    for (const auto& [from_vertex_id, to_vertex_id] : edges)
+      work_graph.connect_vertices(from_vertex_id, to_vertex_id);
 }
 
 }  // namespace
@@ -180,66 +251,83 @@ void GraphGenerator::generate_gray_branch(Graph& work_graph,
   }
 }
 
-void GraphGenerator::generate_new_vertices(
-    Graph& graph,
-    const VertexId& parent_vertex_id) const {
-  std::list<std::function<void()>> jobs;
-  std::atomic<int> completed_jobs = 0;
-  std::mutex graph_mutex;
-  for (int i = 0; i < params_.new_vertices_num; i++)
-    jobs.emplace_back(
-        [this, &graph, &completed_jobs, &graph_mutex, parent_vertex_id]() {
-          generate_gray_branch(graph, graph_mutex, parent_vertex_id, 1);
-          completed_jobs++;
-        });
+void GraphGenerator::generate_gray_layers(Graph& graph,
+                                          const VertexId& root_vertex_id,
+                                          std::uint64_t seed) const {
+  auto& thread_pool = ThreadPool::get_thread_pool();
+  std::vector<VertexId> frontier = {root_vertex_id};
+  for (int current_depth = 0; !frontier.empty(); current_depth++) {
+    // The root always gets all of its children, the deepest layer none.
+    if (current_depth > 0 && current_depth >= params_.depth)
+      break;
+    const double probability =
+        static_cast<double>(current_depth) / static_cast<double>(params_.depth);
 
-  std::atomic<bool> should_terminate = false;
-  std::mutex jobs_mutex;
-  auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
-    while (true) {
-      if (should_terminate) {
-        return;
-      }
-      const auto job_optional =
-          [&jobs_mutex, &jobs]() -> std::optional<std::function<void()>> {
-        const std::lock_guard lock(jobs_mutex);
-        if (jobs.empty()) {
-          return std::nullopt;
-        }
-        const auto job = jobs.front();
-        jobs.pop_front();
-        return job;
-      }();
-      if (job_optional.has_value()) {
-        const auto& job = job_optional.value();
-        job();
-      }
-    }
-  };
+    // Workers draw the children count of their part of the frontier, then
+    // a prefix sum over the counts gives every child its canonical id.
+    std::vector<int> children_offsets(frontier.size() + 1, 0);
+    thread_pool.run_in_parallel(
+        frontier.size(), MIN_LAYER_PART_SIZE,
+        [this, &frontier, &children_offsets, current_depth, probability,
+         seed](int begin, int end) {
+          for (int index = begin; index < end; index++) {
+            auto random = PhiloxGenerator(seed, GRAY_STREAM, frontier[index]);
+            int children_count = 0;
+            for (int slot = 0; slot < params_.new_vertices_num; slot++)
+              if (current_depth == 0 || random.get_real() > probability)
+                children_count++;
+            children_offsets[index + 1] = children_count;
+          }
+        });
+    std::partial_sum(children_offsets.begin(), children_offsets.end(),
+                     children_offsets.begin());
+    const int layer_size = children_offsets.back();
 
-  const auto threads_number =
-      std::min(params_.new_vertices_num, MAX_THREADS_COUNT);
-  auto threads = std::vector<std::thread>();
-  threads.reserve(threads_number);
+    std::vector<VertexId> parent_vertex_ids(layer_size);
+    thread_pool.run_in_parallel(
+        frontier.size(), MIN_LAYER_PART_SIZE,
+        [&frontier, &children_offsets, &parent_vertex_ids](int begin, int end) {
+          for (int index = begin; index < end; index++)
+            std::fill(parent_vertex_ids.begin() + children_offsets[index],
+                      parent_vertex_ids.begin() + children_offsets[index + 1],
+                      frontier[index]);
+        });
 
-  for (int i = 0; i < threads_number; ++i) {
-    threads.emplace_back(worker);
+    // Committing the whole layer at once needs no locking.
+    const VertexId first_vertex_id =
+        graph.add_child_vertices(parent_vertex_ids);
+    frontier.resize(layer_size);
+    std::iota(frontier.begin(), frontier.end(), first_vertex_id);
   }
+}
 
-  while (completed_jobs != params_.new_vertices_num) {
-  }
+void GraphGenerator::generate_new_vertices(Graph& graph,
+                                           const VertexId& parent_vertex_id,
+                                           std::uint64_t seed) const {
+  auto& thread_pool = ThreadPool::get_thread_pool();
+  Latch branches_latch(params_.new_vertices_num);
+  std::mutex graph_mutex;
+  for (int i = 0; i < params_.new_vertices_num; i++)
+    thread_pool.submit([this, &graph, &branches_latch, &graph_mutex,
+                        parent_vertex_id, seed, i]() {
+      RandomGenerator::get_thread_generator().set_seed(
+          derive_seed(seed, GRAY_STREAM + i));
+      generate_gray_branch(graph, graph_mutex, parent_vertex_id, 1);
+      branches_latch.count_down();
+    });
 
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
-  }
+  thread_pool.wait(branches_latch);
 }
 
 Graph GraphGenerator::generate() const {
+  const std::uint64_t seed = params_.seed.value_or(std::random_device()());
   auto graph = Graph();
   const auto parent_vertex_id = graph.add_vertex();
-  generate_new_vertices(graph, parent_vertex_id);
-  paint_edges(graph);
+  if (params_.deterministic)
+    generate_gray_layers(graph, parent_vertex_id, seed);
+  else
+    generate_new_vertices(graph, parent_vertex_id, seed);
+  paint_edges(graph, seed);
   return graph;
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <mutex>
+#include <optional>
 
 namespace uni_cpp_practice {
 
@@ -9,11 +11,24 @@ class Graph;
 class GraphGenerator {
  public:
   struct Params {
-    Params(int _depth, int _new_vertices_num)
-        : depth(_depth), new_vertices_num(_new_vertices_num){};
+    Params(int _depth,
+           int _new_vertices_num,
+           std::optional<std::uint64_t> _seed = std::nullopt,
+           bool _deterministic = false)
+        : depth(_depth),
+          new_vertices_num(_new_vertices_num),
+          seed(_seed),
+          deterministic(_deterministic){};
 
     int depth = 0;
     int new_vertices_num = 0;
+    // Every gray branch and painting pass draws from its own random stream
+    // derived from this seed. Picked from std::random_device if unset.
+    std::optional<std::uint64_t> seed = std::nullopt;
+    // Builds the gray tree layer by layer with ids in canonical order and
+    // keys every random decision by (seed, vertex, slot), so a given seed
+    // yields a bit-identical graph whatever the threads count.
+    bool deterministic = false;
   };
 
   Graph generate() const;
@@ -27,8 +42,12 @@ class GraphGenerator {
                             std::mutex& graph_mutex,
                             const VertexId& parent_vertex_id,
                             int current_depth) const;
+  void generate_gray_layers(Graph& graph,
+                            const VertexId& root_vertex_id,
+                            std::uint64_t seed) const;
   void generate_new_vertices(Graph& graph,
-                             const VertexId& parent_vertex_id) const;
+                             const VertexId& parent_vertex_id,
+                             std::uint64_t seed) const;
 };
 
 }  // namespace uni_cpp_practice
@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 #include "graph_printing.hpp"
 #include "graph_traverser.hpp"
@@ -37,29 +38,32 @@ std::string color_to_string(const Edge::Color& color) {
   }
 }
 
-std::string edge_to_json(const Edge& edge) {
+std::string edge_to_json(const FrozenGraph& graph, const EdgeId& edge_id) {
+  const auto& connected_vertices = graph.get_connected_vertices(edge_id);
   std::string res;
   res = "{ \"id\": ";
-  res += to_string(edge.id);
+  res += to_string(edge_id);
   res += ", \"vertex_ids\": [";
-  res += to_string(edge.connected_vertices[0]);
+  res += to_string(connected_vertices[0]);
   res += ", ";
-  res += to_string(edge.connected_vertices[1]);
+  res += to_string(connected_vertices[1]);
   res += "], \"color\": ";
-  res += color_to_string(edge.color);
+  res += color_to_string(graph.get_edge_color(edge_id));
   res += " }";
   return res;
 }
 
-std::string vertex_to_json(const Vertex& vertex) {
+std::string vertex_to_json(const FrozenGraph& graph,
+                           const VertexId& vertex_id) {
+  const auto edge_ids = graph.get_edge_ids(vertex_id);
   std::string res;
   res = "{ \"id\": ";
-  res += to_string(vertex.get_id()) + ", \"edge_ids\": [";
-  for (const auto& edge_id : vertex.get_edges_ids()) {
+  res += to_string(vertex_id) + ", \"edge_ids\": [";
+  for (const auto& edge_id : edge_ids) {
     res += to_string(edge_id);
     res += ", ";
   }
-  if (vertex.get_edges_ids().size() > 0) {
+  if (edge_ids.size() > 0) {
     res.pop_back();
     res.pop_back();
   }
@@ -67,25 +71,26 @@ std::string vertex_to_json(const Vertex& vertex) {
   return res;
 }
 
-std::string graph_to_json(const Graph& graph) {
+std::string graph_to_json(const FrozenGraph& graph) {
   std::string res;
   res = "{ \"depth\": ";
   res += to_string(graph.get_depth());
   res += ", \"vertices\": [ ";
-  for (const auto& [vertex_id, vertex] : graph.get_vertices()) {
-    res += vertex_to_json(vertex);
+  for (VertexId vertex_id = 0; vertex_id < graph.get_vertices_count();
+       vertex_id++) {
+    res += vertex_to_json(graph, vertex_id);
     res += ", ";
   }
-  if (graph.get_vertices().size()) {
+  if (graph.get_vertices_count()) {
     res.pop_back();
     res.pop_back();
   }
   res += " ], \"edges\": [ ";
-  for (const auto& [edge_id, edge] : graph.get_edges()) {
-    res += edge_to_json(edge);
+  for (EdgeId edge_id = 0; edge_id < graph.get_edges_count(); edge_id++) {
+    res += edge_to_json(graph, edge_id);
     res += ", ";
   }
-  if (graph.get_edges().size() > 0) {
+  if (graph.get_edges_count() > 0) {
     res.pop_back();
     res.pop_back();
   }
@@ -2,19 +2,18 @@
 
 #include <string>
 
+#include "frozen_graph.hpp"
 #include "graph_traverser.hpp"
 
 namespace uni_cpp_practice {
 
-class Graph;
-
 namespace graph_printing {
 
 std::string color_to_string(const Edge::Color& color);
 
-std::string graph_to_json(const Graph& graph);
-std::string vertex_to_json(const Vertex& graph);
-std::string edge_to_json(const Graph& graph);
+std::string graph_to_json(const FrozenGraph& graph);
+std::string vertex_to_json(const FrozenGraph& graph, const VertexId& vertex_id);
+std::string edge_to_json(const FrozenGraph& graph, const EdgeId& edge_id);
 
 std::string path_to_json(const GraphTraverser::Path& path);
 
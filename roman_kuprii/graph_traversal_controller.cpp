@@ -1,14 +1,15 @@
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
-#include <list>
 #include <mutex>
-#include <optional>
-#include <random>
-#include <thread>
+#include <utility>
 #include <vector>
 
-#include "graph.hpp"
+#include "frozen_graph.hpp"
 #include "graph_traversal_controller.hpp"
 #include "graph_traverser.hpp"
+#include "thread_pool.hpp"
 
 namespace uni_cpp_practice {
 
@@ -16,94 +17,107 @@ namespace graph_traversal_controller {
 
 GraphTraversalController::GraphTraversalController(
     int threads_count,
-    const std::vector<Graph>& graphs)
-    : graphs_(graphs) {
-  threads_count = std::min(threads_count, static_cast<int>(graphs.size()));
-  for (int iter = 0; iter < threads_count; iter++) {
-    workers_.emplace_back(
-        [&jobs_ = jobs_,
-         &get_job_mutex_ = get_job_mutex_]() -> std::optional<JobCallback> {
-          const std::lock_guard lock(get_job_mutex_);
-          if (jobs_.empty()) {
-            return std::nullopt;
-          }
-          const auto job = jobs_.front();
-          jobs_.pop_front();
-          return job;
-        });
-  }
-}
+    const std::vector<FrozenGraph>& graphs)
+    : threads_count_(std::min(threads_count, static_cast<int>(graphs.size()))),
+      graphs_(&graphs) {}
+
+GraphTraversalController::GraphTraversalController(int threads_count)
+    : threads_count_(threads_count) {}
 
 void GraphTraversalController::traverse_graphs(
     const GenStartedCallback& gen_started_callback,
     const GenFinishedCallback& gen_finished_callback) {
-  std::atomic<int> completed_jobs = 0;
+  auto& thread_pool = ThreadPool::get_thread_pool();
+  const int graphs_count = graphs_->size();
+  Latch graphs_latch(graphs_count);
+  std::atomic<int> next_graph_index = threads_count_;
 
-  for (auto& worker : workers_) {
-    worker.start();
-  }
+  // Every finished job submits the next graph, which keeps threads_count_
+  // graphs in flight.
+  std::function<void(int)> traverse_graph;
+  traverse_graph = [this, &gen_started_callback, &gen_finished_callback,
+                    &thread_pool, &graphs_latch, &next_graph_index,
+                    &traverse_graph, graphs_count](int i) {
+    {
+      const std::lock_guard lock(start_callback_mutex_);
+      gen_started_callback(i);
+    }
 
-  {
-    std::lock_guard lock(get_job_mutex_);
-    for (int i = 0; i < graphs_.size(); i++) {
-      jobs_.emplace_back([&gen_started_callback = gen_started_callback,
-                          &gen_finished_callback = gen_finished_callback, i,
-                          &finish_callback_mutex_ = finish_callback_mutex_,
-                          &start_callback_mutex_ = start_callback_mutex_,
-                          &completed_jobs = completed_jobs,
-                          &graphs_ = graphs_]() {
-        {
-          const std::lock_guard lock(start_callback_mutex_);
-          gen_started_callback(i);
-        }
-
-        GraphTraverser graph_traverser(graphs_[i]);
-        const auto paths = graph_traverser.traverse_graph();
-
-        {
-          const std::lock_guard lock(finish_callback_mutex_);
-          gen_finished_callback(i, std::move(paths));
-        }
-        completed_jobs++;
-      });
+    GraphTraverser graph_traverser((*graphs_)[i]);
+    const auto paths = graph_traverser.traverse_graph();
+
+    {
+      const std::lock_guard lock(finish_callback_mutex_);
+      gen_finished_callback(i, paths);
     }
+
+    const int next_index = next_graph_index++;
+    if (next_index < graphs_count)
+      thread_pool.submit(
+          [&traverse_graph, next_index]() { traverse_graph(next_index); });
+    graphs_latch.count_down();
+  };
+
+  for (int i = 0; i < threads_count_; i++)
+    thread_pool.submit([&traverse_graph, i]() { traverse_graph(i); });
+
+  thread_pool.wait(graphs_latch);
+}
+
+void GraphTraversalController::enqueue_graph(
+    int index,
+    FrozenGraph graph,
+    GenStartedCallback gen_started_callback,
+    GenFinishedCallback gen_finished_callback) {
+  enqueued_graphs_count_++;
+  {
+    const std::lock_guard lock(schedule_mutex_);
+    queued_graphs_.push_back({index, std::move(graph),
+                              std::move(gen_started_callback),
+                              std::move(gen_finished_callback)});
   }
-  while (completed_jobs != graphs_.size()) {
+  submit_next_graphs();
+}
+
+void GraphTraversalController::traverse_queued_graph(
+    const QueuedGraph& queued_graph) {
+  {
+    const std::lock_guard lock(start_callback_mutex_);
+    queued_graph.gen_started_callback(queued_graph.index);
   }
 
-  for (auto& worker : workers_) {
-    worker.stop();
+  GraphTraverser graph_traverser(queued_graph.graph);
+  const auto paths = graph_traverser.traverse_graph();
+
+  {
+    const std::lock_guard lock(finish_callback_mutex_);
+    queued_graph.gen_finished_callback(queued_graph.index, paths);
   }
-}
 
-GraphTraversalController::Worker::~Worker() {
-  if (state_ == State::Working)
-    stop();
+  {
+    const std::lock_guard lock(schedule_mutex_);
+    running_graphs_count_--;
+  }
+  submit_next_graphs();
+  traversed_graphs_count_++;
 }
 
-void GraphTraversalController::Worker::start() {
-  assert(state_ != State::Working);
-  state_ = State::Working;
-  thread_ =
-      std::thread([&state_ = state_, &get_job_callback_ = get_job_callback_]() {
-        while (true) {
-          if (state_ == State::ShouldTerminate) {
-            state_ = State::Idle;
-            return;
-          }
-          const auto job_optional = get_job_callback_();
-          if (job_optional.has_value()) {
-            job_optional.value()();
-          }
-        }
-      });
+void GraphTraversalController::submit_next_graphs() {
+  const std::lock_guard lock(schedule_mutex_);
+  while (!queued_graphs_.empty() && running_graphs_count_ < threads_count_) {
+    running_graphs_count_++;
+    ThreadPool::get_thread_pool().submit(
+        [this, queued_graph = std::move(queued_graphs_.front())]() {
+          traverse_queued_graph(queued_graph);
+        });
+    queued_graphs_.pop_front();
+  }
 }
 
-void GraphTraversalController::Worker::stop() {
-  assert(state_ == State::Working);
-  state_ = State::ShouldTerminate;
-  if (thread_.joinable())
-    thread_.join();
+void GraphTraversalController::wait_enqueued_graphs() {
+  ThreadPool::get_thread_pool().wait_until([this]() {
+    return traversed_graphs_count_ == enqueued_graphs_count_;
+  });
 }
 
 }  // namespace graph_traversal_controller
@@ -1,58 +1,68 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <functional>
-#include <list>
 #include <mutex>
-#include <optional>
-#include <thread>
+#include <vector>
 
+#include "frozen_graph.hpp"
 #include "graph_traverser.hpp"
 
 namespace uni_cpp_practice {
 
-class Graph;
-
 namespace graph_traversal_controller {
 
 class GraphTraversalController {
  public:
-  using JobCallback = std::function<void()>;
-  using GetJobCallback = std::function<std::optional<JobCallback>()>;
   using GenStartedCallback = std::function<void(int)>;
   using GenFinishedCallback =
       std::function<void(int, const std::vector<GraphTraverser::Path>&)>;
 
-  class Worker {
-   public:
-    explicit Worker(const GetJobCallback& get_job_callback)
-        : get_job_callback_(get_job_callback){};
-
-    enum class State { Idle, Working, ShouldTerminate };
-
-    void start();
-    void stop();
-
-    ~Worker();
-
-   private:
-    std::thread thread_;
-    GetJobCallback get_job_callback_;
-    std::atomic<State> state_ = State::Idle;
-  };
+  GraphTraversalController(int threads_count,
+                           const std::vector<FrozenGraph>& graphs);
 
-  GraphTraversalController(int threads_count, const std::vector<Graph>& graphs);
+  // Pipeline mode: graphs arrive one by one through enqueue_graph().
+  explicit GraphTraversalController(int threads_count);
 
+  // Traverses the graphs as jobs of the shared thread pool, at most
+  // threads_count of them at a time.
   void traverse_graphs(const GenStartedCallback& gen_started_callback,
                        const GenFinishedCallback& gen_finished_callback);
 
+  // Traverses |graph| as a job of the shared thread pool, waiting in a
+  // queue while threads_count graphs are traversed. The graph is released
+  // as soon as |gen_finished_callback| returns.
+  void enqueue_graph(int index,
+                     FrozenGraph graph,
+                     GenStartedCallback gen_started_callback,
+                     GenFinishedCallback gen_finished_callback);
+
+  // Waits until every graph passed to enqueue_graph() is traversed.
+  void wait_enqueued_graphs();
+
  private:
-  std::list<Worker> workers_;
-  std::list<JobCallback> jobs_;
-  const std::vector<Graph>& graphs_;
+  struct QueuedGraph {
+    int index;
+    FrozenGraph graph;
+    GenStartedCallback gen_started_callback;
+    GenFinishedCallback gen_finished_callback;
+  };
+
+  int threads_count_;
+  const std::vector<FrozenGraph>* graphs_ = nullptr;
+  std::atomic<int> enqueued_graphs_count_ = 0;
+  std::atomic<int> traversed_graphs_count_ = 0;
   std::mutex start_callback_mutex_;
   std::mutex finish_callback_mutex_;
-  std::mutex get_job_mutex_;
+
+  // Guard the queue of enqueued graphs and the count of running ones.
+  std::mutex schedule_mutex_;
+  std::deque<QueuedGraph> queued_graphs_;
+  int running_graphs_count_ = 0;
+
+  void traverse_queued_graph(const QueuedGraph& queued_graph);
+  void submit_next_graphs();
 };
 
 }  // namespace graph_traversal_controller
@@ -1,135 +1,820 @@
+#include <algorithm>
 #include <atomic>
 #include <cassert>
-#include <functional>
-#include <list>
+#include <cstddef>
+#include <cstdint>
 #include <mutex>
-#include <optional>
-#include <queue>
-#include <thread>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 #include "graph_traverser.hpp"
+#include "landmark_index.hpp"
+#include "thread_pool.hpp"
+#include "traversal_workspace.hpp"
 
 namespace uni_cpp_practice {
 
 namespace {
 
-constexpr int UNVISITED = 0;
-constexpr int VISITED = 1;
-constexpr int MAX_DISTANCE = 10000;
-const unsigned long MAX_WORKERS_COUNT = std::thread::hardware_concurrency();
+using Distance = GraphTraverser::Distance;
+using Path = GraphTraverser::Path;
+
+// Direction switching thresholds of the breadth first search, as tuned by
+// Beamer et al.: go bottom up once the edges out of the frontier exceed
+// 1/ALPHA of the unexplored ones, and back top down once the frontier
+// stops growing and holds fewer than 1/BETA of the vertices.
+constexpr std::int64_t ALPHA = 15;
+constexpr std::int64_t BETA = 18;
+
+// Smaller graphs are searched on the calling thread alone.
+constexpr int MIN_PARALLEL_SEARCH_VERTICES_COUNT = 1 << 16;
+constexpr int MIN_FRONTIER_PART_SIZE = 1024;
+
+constexpr int SOURCES_BATCH_SIZE = 64;
+// Every batch searched at the same time holds 24 bytes per vertex, so on
+// large graphs fewer of them run at once than there are workers.
+constexpr std::int64_t MAX_BATCH_MASKS_BYTES = std::int64_t(1) << 30;
+
+// Reaches the unreached out-neighbors of every frontier vertex and returns
+// the number of edges going out of the newly reached ones. Both expansions
+// stop as soon as the last destination is reached.
+std::int64_t expand_top_down(const FrozenGraph& graph,
+                             int frontier_begin,
+                             int frontier_end,
+                             Distance next_distance,
+                             int& destinations_count,
+                             TraversalWorkspace& workspace) {
+  const auto& vertices_queue = workspace.get_vertices_queue();
+  std::int64_t next_frontier_edges_count = 0;
+  for (int index = frontier_begin; index < frontier_end; index++) {
+    const auto current_vertex_id = vertices_queue[index];
+    for (const auto& next_vertex_id :
+         graph.get_neighbor_ids(current_vertex_id)) {
+      if (workspace.is_reached(next_vertex_id))
+        continue;
+      workspace.reach(next_vertex_id, current_vertex_id, next_distance);
+      if (workspace.is_destination(next_vertex_id) &&
+          --destinations_count == 0)
+        return next_frontier_edges_count;
+      next_frontier_edges_count +=
+          graph.get_neighbor_ids(next_vertex_id).size();
+    }
+  }
+  return next_frontier_edges_count;
+}
+
+// Lets every unreached vertex look for a frontier vertex among its
+// predecessors, stopping at the first one. On a wide frontier most
+// unreached vertices find a parent quickly, so fewer edges are checked
+// than top down.
+void expand_bottom_up(const FrozenGraph& graph,
+                      int frontier_begin,
+                      int frontier_end,
+                      Distance next_distance,
+                      int& destinations_count,
+                      TraversalWorkspace& workspace) {
+  workspace.set_frontier(frontier_begin, frontier_end);
+  const int vertices_count = graph.get_vertices_count();
+  for (VertexId vertex_id = workspace.find_next_unreached(0);
+       vertex_id < vertices_count;
+       vertex_id = workspace.find_next_unreached(vertex_id + 1)) {
+    for (const auto& predecessor_id : graph.get_predecessor_ids(vertex_id))
+      if (workspace.is_in_frontier(predecessor_id)) {
+        workspace.reach(vertex_id, predecessor_id, next_distance);
+        if (workspace.is_destination(vertex_id) && --destinations_count == 0)
+          return;
+        break;
+      }
+  }
+}
+
+// Searches along outgoing edges from the source, layer by layer, until
+// |destinations_count| vertices marked in the workspace are reached or
+// nothing is left to visit. Every layer is expanded either top down or
+// bottom up, whichever should check fewer edges.
+void search(const FrozenGraph& graph,
+            const VertexId& source_vertex_id,
+            int destinations_count,
+            TraversalWorkspace& workspace) {
+  const auto& vertices_queue = workspace.get_vertices_queue();
+  const std::int64_t vertices_count = graph.get_vertices_count();
+  std::int64_t unexplored_edges_count = graph.get_edges_count();
+  std::int64_t frontier_edges_count =
+      graph.get_neighbor_ids(source_vertex_id).size();
+  workspace.reach(source_vertex_id, INVALID_ID, 0);
+  if (workspace.is_destination(source_vertex_id))
+    destinations_count--;
+
+  int frontier_begin = 0;
+  int frontier_end = 1;
+  Distance distance = 0;
+  // Moves the frontier to the vertices reached by the last expansion.
+  const auto advance_frontier = [&]() {
+    frontier_begin = frontier_end;
+    frontier_end = vertices_queue.size();
+    return frontier_end - frontier_begin;
+  };
+
+  while (frontier_begin < frontier_end && destinations_count > 0) {
+    if (frontier_edges_count * ALPHA > unexplored_edges_count) {
+      std::int64_t frontier_size = frontier_end - frontier_begin;
+      std::int64_t previous_frontier_size = 0;
+      do {
+        previous_frontier_size = frontier_size;
+        expand_bottom_up(graph, frontier_begin, frontier_end, ++distance,
+                         destinations_count, workspace);
+        frontier_size = advance_frontier();
+      } while (frontier_size > 0 && destinations_count > 0 &&
+               (frontier_size >= previous_frontier_size ||
+                frontier_size * BETA > vertices_count));
+      // Too expensive to count exactly, so just let top down run at least
+      // one layer.
+      frontier_edges_count = 1;
+    } else {
+      unexplored_edges_count -= frontier_edges_count;
+      frontier_edges_count =
+          expand_top_down(graph, frontier_begin, frontier_end, ++distance,
+                          destinations_count, workspace);
+      advance_frontier();
+    }
+  }
+}
+
+// Parents and distances found by search_in_parallel(). A vertex belongs to
+// the expansion that sets its reached bit first, so its parent and
+// distance are written exactly once.
+class ConcurrentSearchTree {
+ public:
+  explicit ConcurrentSearchTree(int vertices_count)
+      : reached_words_((vertices_count + 63) / 64),
+        parent_vertex_ids_(vertices_count),
+        distances_(vertices_count) {
+    for (auto& word : reached_words_)
+      word.store(0, std::memory_order_relaxed);
+  }
+
+  bool is_reached(const VertexId& vertex_id) const {
+    return (get_reached_word(vertex_id >> 6) >> (vertex_id & 63)) & 1;
+  }
+  // Reached bits of the vertices [64 * word_index, 64 * word_index + 64).
+  std::uint64_t get_reached_word(int word_index) const {
+    return reached_words_[word_index].load(std::memory_order_relaxed);
+  }
+
+  // Returns false if the vertex was already reached by someone else.
+  bool try_reach(const VertexId& vertex_id,
+                 const VertexId& parent_vertex_id,
+                 Distance distance) {
+    const std::uint64_t bit = std::uint64_t(1) << (vertex_id & 63);
+    auto& word = reached_words_[vertex_id >> 6];
+    if ((word.load(std::memory_order_relaxed) & bit) ||
+        (word.fetch_or(bit, std::memory_order_relaxed) & bit))
+      return false;
+    parent_vertex_ids_[vertex_id] = parent_vertex_id;
+    distances_[vertex_id] = distance;
+    return true;
+  }
+
+  VertexId get_parent_vertex_id(const VertexId& vertex_id) const {
+    return parent_vertex_ids_[vertex_id];
+  }
+  Distance get_distance(const VertexId& vertex_id) const {
+    return distances_[vertex_id];
+  }
+
+ private:
+  std::vector<std::atomic<std::uint64_t>> reached_words_;
+  std::vector<VertexId> parent_vertex_ids_;
+  std::vector<Distance> distances_;
+};
+
+// Frontier of search_in_parallel() with the vertices reached from it. Each
+// part of an expansion collects the vertices it reached into its own
+// buffer, and the buffers are merged into the next frontier.
+struct ParallelFrontier {
+  std::vector<VertexId> vertex_ids;
+  std::vector<VertexId> next_vertex_ids;
+  std::mutex next_vertex_ids_mutex;
+  // Frontier bits for bottom up expansions, filled only for those.
+  std::vector<std::uint64_t> words;
+
+  bool is_in_frontier(const VertexId& vertex_id) const {
+    return (words[vertex_id >> 6] >> (vertex_id & 63)) & 1;
+  }
+
+  void add_next_vertex_ids(const std::vector<VertexId>& part_vertex_ids) {
+    const std::lock_guard lock(next_vertex_ids_mutex);
+    next_vertex_ids.insert(next_vertex_ids.end(), part_vertex_ids.begin(),
+                           part_vertex_ids.end());
+  }
+};
+
+// Parallel expand_top_down(). Ties between parents are broken by whichever
+// part gets there first.
+std::int64_t expand_top_down_in_parallel(
+    const FrozenGraph& graph,
+    const std::vector<bool>& is_destination,
+    Distance next_distance,
+    std::atomic<int>& destinations_count,
+    ParallelFrontier& frontier,
+    ConcurrentSearchTree& tree) {
+  std::atomic<std::int64_t> next_frontier_edges_count = 0;
+  ThreadPool::get_thread_pool().run_in_parallel(
+      frontier.vertex_ids.size(), MIN_FRONTIER_PART_SIZE,
+      [&graph, &is_destination, &destinations_count, &frontier, &tree,
+       &next_frontier_edges_count, next_distance](int begin, int end) {
+        std::vector<VertexId> part_vertex_ids;
+        std::int64_t part_edges_count = 0;
+        for (int index = begin; index < end; index++) {
+          const auto vertex_id = frontier.vertex_ids[index];
+          for (const auto& next_vertex_id : graph.get_neighbor_ids(vertex_id))
+            if (tree.try_reach(next_vertex_id, vertex_id, next_distance)) {
+              part_vertex_ids.push_back(next_vertex_id);
+              part_edges_count +=
+                  graph.get_neighbor_ids(next_vertex_id).size();
+              if (is_destination[next_vertex_id])
+                destinations_count--;
+            }
+        }
+        next_frontier_edges_count += part_edges_count;
+        frontier.add_next_vertex_ids(part_vertex_ids);
+      });
+  return next_frontier_edges_count;
+}
+
+// Parallel expand_bottom_up(). Every part owns whole words of reached bits
+// and only reaches its own vertices, so the first frontier predecessor
+// found is always the parent.
+void expand_bottom_up_in_parallel(const FrozenGraph& graph,
+                                  const std::vector<bool>& is_destination,
+                                  Distance next_distance,
+                                  std::atomic<int>& destinations_count,
+                                  ParallelFrontier& frontier,
+                                  ConcurrentSearchTree& tree) {
+  const int vertices_count = graph.get_vertices_count();
+  const int words_count = (vertices_count + 63) / 64;
+  frontier.words.assign(words_count, 0);
+  for (const auto& vertex_id : frontier.vertex_ids)
+    frontier.words[vertex_id >> 6] |= std::uint64_t(1) << (vertex_id & 63);
+
+  ThreadPool::get_thread_pool().run_in_parallel(
+      words_count, MIN_FRONTIER_PART_SIZE / 64,
+      [&graph, &is_destination, &destinations_count, &frontier, &tree,
+       next_distance, vertices_count](int begin, int end) {
+        std::vector<VertexId> part_vertex_ids;
+        for (int word_index = begin;
+             word_index < end && destinations_count > 0; word_index++) {
+          for (std::uint64_t unreached = ~tree.get_reached_word(word_index);
+               unreached != 0; unreached &= unreached - 1) {
+            const VertexId vertex_id =
+                word_index * 64 + __builtin_ctzll(unreached);
+            if (vertex_id >= vertices_count)
+              break;
+            for (const auto& predecessor_id :
+                 graph.get_predecessor_ids(vertex_id))
+              if (frontier.is_in_frontier(predecessor_id)) {
+                tree.try_reach(vertex_id, predecessor_id, next_distance);
+                part_vertex_ids.push_back(vertex_id);
+                if (is_destination[vertex_id])
+                  destinations_count--;
+                break;
+              }
+          }
+        }
+        frontier.add_next_vertex_ids(part_vertex_ids);
+      });
+}
+
+// Level synchronous search with every frontier split between the pool
+// workers. Chooses between top down and bottom up expansions the same way
+// as search().
+void search_in_parallel(const FrozenGraph& graph,
+                        const VertexId& source_vertex_id,
+                        const std::vector<bool>& is_destination,
+                        int destinations_count,
+                        ConcurrentSearchTree& tree) {
+  const std::int64_t vertices_count = graph.get_vertices_count();
+  tree.try_reach(source_vertex_id, INVALID_ID, 0);
+  std::atomic<int> left_destinations_count =
+      destinations_count - (is_destination[source_vertex_id] ? 1 : 0);
+  ParallelFrontier frontier;
+  frontier.vertex_ids.push_back(source_vertex_id);
+
+  std::int64_t unexplored_edges_count = graph.get_edges_count();
+  std::int64_t frontier_edges_count =
+      graph.get_neighbor_ids(source_vertex_id).size();
+  bool is_bottom_up = false;
+  std::int64_t previous_frontier_size = 0;
+  for (Distance next_distance = 1;
+       !frontier.vertex_ids.empty() && left_destinations_count > 0;
+       next_distance++) {
+    const std::int64_t frontier_size = frontier.vertex_ids.size();
+    if (!is_bottom_up) {
+      is_bottom_up = frontier_edges_count * ALPHA > unexplored_edges_count;
+    } else if (frontier_size < previous_frontier_size &&
+               frontier_size * BETA <= vertices_count) {
+      is_bottom_up = false;
+      // Too expensive to count exactly, so just let top down run at least
+      // one layer.
+      frontier_edges_count = 1;
+    }
+    previous_frontier_size = frontier_size;
+
+    frontier.next_vertex_ids.clear();
+    if (is_bottom_up) {
+      expand_bottom_up_in_parallel(graph, is_destination, next_distance,
+                                   left_destinations_count, frontier, tree);
+    } else {
+      unexplored_edges_count -= frontier_edges_count;
+      frontier_edges_count = expand_top_down_in_parallel(
+          graph, is_destination, next_distance, left_destinations_count,
+          frontier, tree);
+    }
+    std::swap(frontier.vertex_ids, frontier.next_vertex_ids);
+  }
+}
+
+// Per vertex source masks of a multi-source search. A thread allocates
+// them once and reuses them for every batch it searches. The vertices with
+// a non-zero mask are listed too, so a layer only touches the vertices on
+// it and a batch only clears the ones it has seen.
+struct BatchMasks {
+  explicit BatchMasks(int vertices_count)
+      : seen(vertices_count, 0),
+        frontier(vertices_count, 0),
+        next_frontier(vertices_count, 0) {}
+
+  std::vector<std::uint64_t> seen;
+  std::vector<std::uint64_t> frontier;
+  std::vector<std::uint64_t> next_frontier;
+  std::vector<VertexId> seen_vertex_ids;
+  std::vector<VertexId> frontier_vertex_ids;
+  std::vector<VertexId> next_frontier_vertex_ids;
+};
+
+// Searches from up to 64 sources at once. Every vertex keeps a mask of the
+// sources that have reached it and a mask of those that reached it in the
+// last layer, so one sweep over an edge serves all sources whose
+// frontiers it lies on. Leaves |masks| cleared.
+void find_batch_distances(
+    const FrozenGraph& graph,
+    const std::vector<VertexId>& source_vertex_ids,
+    int batch_begin,
+    const std::vector<int>& destination_columns,
+    const std::vector<VertexId>& column_vertex_ids,
+    BatchMasks& masks,
+    std::vector<std::vector<Distance>>& distances) {
+  const int batch_size = std::min<int>(
+      SOURCES_BATCH_SIZE, source_vertex_ids.size() - batch_begin);
+  const std::uint64_t batch_mask =
+      batch_size == 64 ? ~std::uint64_t(0)
+                       : (std::uint64_t(1) << batch_size) - 1;
+  auto& seen = masks.seen;
+  auto& frontier = masks.frontier;
+  auto& next_frontier = masks.next_frontier;
+
+  // Records the sources that have just reached the vertex.
+  const auto record = [&destination_columns, &distances, batch_begin](
+                          const VertexId& vertex_id, std::uint64_t sources,
+                          Distance distance) {
+    const int column = destination_columns[vertex_id];
+    if (column == INVALID_ID)
+      return;
+    for (; sources != 0; sources &= sources - 1)
+      distances[batch_begin + __builtin_ctzll(sources)][column] = distance;
+  };
+
+  for (int bit = 0; bit < batch_size; bit++) {
+    const auto vertex_id = source_vertex_ids[batch_begin + bit];
+    if (seen[vertex_id] == 0) {
+      masks.seen_vertex_ids.push_back(vertex_id);
+      masks.frontier_vertex_ids.push_back(vertex_id);
+    }
+    seen[vertex_id] |= std::uint64_t(1) << bit;
+    frontier[vertex_id] |= std::uint64_t(1) << bit;
+  }
+  for (const auto& vertex_id : masks.frontier_vertex_ids)
+    record(vertex_id, frontier[vertex_id], 0);
+
+  for (Distance distance = 1; !masks.frontier_vertex_ids.empty(); distance++) {
+    for (const auto& vertex_id : masks.frontier_vertex_ids) {
+      for (const auto& next_vertex_id : graph.get_neighbor_ids(vertex_id)) {
+        const std::uint64_t sources =
+            frontier[vertex_id] & ~seen[next_vertex_id];
+        if (sources == 0)
+          continue;
+        if (next_frontier[next_vertex_id] == 0)
+          masks.next_frontier_vertex_ids.push_back(next_vertex_id);
+        next_frontier[next_vertex_id] |= sources;
+      }
+      frontier[vertex_id] = 0;
+    }
+    masks.frontier_vertex_ids.clear();
+
+    for (const auto& vertex_id : masks.next_frontier_vertex_ids) {
+      const std::uint64_t reached = next_frontier[vertex_id];
+      next_frontier[vertex_id] = 0;
+      if (seen[vertex_id] == 0)
+        masks.seen_vertex_ids.push_back(vertex_id);
+      seen[vertex_id] |= reached;
+      frontier[vertex_id] = reached;
+      masks.frontier_vertex_ids.push_back(vertex_id);
+      record(vertex_id, reached, distance);
+    }
+    masks.next_frontier_vertex_ids.clear();
+
+    bool is_complete = true;
+    for (const auto& vertex_id : column_vertex_ids)
+      is_complete = is_complete && seen[vertex_id] == batch_mask;
+    if (is_complete)
+      break;
+  }
+
+  for (const auto& vertex_id : masks.frontier_vertex_ids)
+    frontier[vertex_id] = 0;
+  masks.frontier_vertex_ids.clear();
+  for (const auto& vertex_id : masks.seen_vertex_ids)
+    seen[vertex_id] = 0;
+  masks.seen_vertex_ids.clear();
+}
+
+template <typename SearchTree>
+Path restore_path(const SearchTree& tree,
+                  const VertexId& destination_vertex_id) {
+  if (!tree.is_reached(destination_vertex_id))
+    throw std::logic_error("Vertices dont connected");
+  std::vector<VertexId> vertex_ids;
+  for (VertexId vertex_id = destination_vertex_id; vertex_id != INVALID_ID;
+       vertex_id = tree.get_parent_vertex_id(vertex_id))
+    vertex_ids.push_back(vertex_id);
+  std::reverse(vertex_ids.begin(), vertex_ids.end());
+  return Path(std::move(vertex_ids), tree.get_distance(destination_vertex_id));
+}
+
+// Fewest edges needed to get from a vertex down to the destination layer:
+// an edge goes at most max_depth_step layers deeper, so it takes at least
+// ceil(layers left / max_depth_step). The estimate drops by at most one
+// per edge, which makes it consistent. Zero on graphs with no edge going
+// deeper.
+class DepthEstimate {
+ public:
+  DepthEstimate(const FrozenGraph& graph,
+                const VertexId& destination_vertex_id)
+      : graph_(graph),
+        max_depth_step_(graph.get_max_depth_step()),
+        destination_depth_(graph.get_vertex_depth(destination_vertex_id)) {}
+
+  Distance operator()(const VertexId& vertex_id) const {
+    const int layers_left =
+        destination_depth_ - graph_.get_vertex_depth(vertex_id);
+    return layers_left > 0 && max_depth_step_ > 0
+               ? (layers_left + max_depth_step_ - 1) / max_depth_step_
+               : 0;
+  }
+
+ private:
+  const FrozenGraph& graph_;
+  const int max_depth_step_;
+  const int destination_depth_;
+};
+
+// A* search with a consistent |get_estimate|, so every vertex is expanded
+// once its distance is final. Vertices estimated UNREACHABLE_DISTANCE away
+// are never opened. Unit edge weights and integer estimates keep the
+// priorities small, so the open set is a bucket per priority. A bucket is
+// used as a stack to go deep first among equals. An entry is stale once
+// its vertex got a shorter distance, as its priority no longer matches the
+// bucket.
+template <typename Estimate>
+Path search_a_star(const FrozenGraph& graph,
+                   const VertexId& source_vertex_id,
+                   const VertexId& destination_vertex_id,
+                   const Estimate& get_estimate) {
+  auto& workspace = TraversalWorkspace::get_thread_workspace();
+  workspace.reset(graph.get_vertices_count());
+  workspace.reach(source_vertex_id, INVALID_ID, 0);
+  std::vector<std::vector<VertexId>> buckets(get_estimate(source_vertex_id) +
+                                             1);
+  buckets.back().push_back(source_vertex_id);
+
+  for (int priority = buckets.size() - 1;
+       priority < static_cast<int>(buckets.size()); priority++) {
+    while (!buckets[priority].empty()) {
+      const auto current_vertex_id = buckets[priority].back();
+      buckets[priority].pop_back();
+      const Distance distance = workspace.get_distance(current_vertex_id);
+      if (distance + get_estimate(current_vertex_id) != priority)
+        continue;
+      if (current_vertex_id == destination_vertex_id)
+        return restore_path(workspace, destination_vertex_id);
+
+      for (const auto& next_vertex_id :
+           graph.get_neighbor_ids(current_vertex_id)) {
+        if (workspace.is_reached(next_vertex_id) &&
+            distance + 1 >= workspace.get_distance(next_vertex_id))
+          continue;
+        const Distance estimate = get_estimate(next_vertex_id);
+        if (estimate == GraphTraverser::UNREACHABLE_DISTANCE)
+          continue;
+        if (!workspace.is_reached(next_vertex_id))
+          workspace.reach(next_vertex_id, current_vertex_id, distance + 1);
+        else
+          workspace.improve(next_vertex_id, current_vertex_id, distance + 1);
+        const int next_priority = distance + 1 + estimate;
+        if (next_priority >= static_cast<int>(buckets.size()))
+          buckets.resize(next_priority + 1);
+        buckets[next_priority].push_back(next_vertex_id);
+      }
+    }
+  }
+
+  throw std::logic_error("Vertices dont connected");
+}
+
+template <typename SearchTree>
+std::vector<Path> restore_pathes(
+    const SearchTree& tree,
+    const std::vector<VertexId>& destination_vertex_ids) {
+  std::vector<Path> pathes;
+  pathes.reserve(destination_vertex_ids.size());
+  for (const auto& destination_vertex_id : destination_vertex_ids)
+    pathes.push_back(restore_path(tree, destination_vertex_id));
+  return pathes;
+}
+
 }  // namespace
 
 GraphTraverser::Path GraphTraverser::find_shortest_path(
-    const Graph& graph,
     const VertexId& source_vertex_id,
     const VertexId& destination_vertex_id) const {
-  assert(graph.is_vertex_exist(source_vertex_id));
-  assert(graph.is_vertex_exist(destination_vertex_id));
-
-  int vertices_number = graph.get_vertices().size();
-  const auto& source_vertex = graph.get_vertices().at(source_vertex_id);
-  // unvisited vertices
-  std::vector<VertexId> vertices(vertices_number, UNVISITED);
-  vertices[source_vertex_id] = VISITED;
-  // create distances
-  std::vector<Distance> distance(vertices_number, MAX_DISTANCE);
-  distance[source_vertex_id] = 0;
-  // create queue
-  std::queue<Vertex> vertices_queue;
-  vertices_queue.push(source_vertex);
-  // create path
-  std::vector<std::vector<VertexId>> all_pathes(vertices_number);
-  std::vector<VertexId> source_vector(1, source_vertex_id);
-  all_pathes[source_vertex_id] = source_vector;
-
-  while (!vertices_queue.empty()) {
-    const auto current_vertex = vertices_queue.front();
-    vertices_queue.pop();
-
-    // check all outcoming edges
-    for (const auto& edge_id : current_vertex.get_edges_ids()) {
-      const auto& edge = graph.get_edges().at(edge_id);
-      VertexId next_vertex_id = edge.connected_vertices.back();
-      const auto& next_vertex = graph.get_vertices().at(next_vertex_id);
-      // update distances
-      if (distance[current_vertex.get_id()] + 1 < distance[next_vertex_id]) {
-        vertices_queue.push(next_vertex);
-        distance[next_vertex_id] = distance[current_vertex.get_id()] + 1;
-        all_pathes[next_vertex_id] = all_pathes[current_vertex.get_id()];
-        all_pathes[next_vertex_id].push_back(next_vertex_id);
-        if (destination_vertex_id == next_vertex_id) {
-          Path r_path(all_pathes[next_vertex_id], distance[next_vertex_id]);
-          return r_path;
+  assert(graph_.is_vertex_exist(source_vertex_id));
+  assert(graph_.is_vertex_exist(destination_vertex_id));
+
+  if (source_vertex_id == destination_vertex_id)
+    return Path({source_vertex_id}, 0);
+
+  // Searches forward from the source along outgoing edges and backward from
+  // the destination along incoming ones, one whole layer at a time, always
+  // growing the smaller frontier. The best meeting point found in the
+  // first layer that meets the other side gives the shortest path.
+  const int vertices_count = graph_.get_vertices_count();
+  auto& forward_workspace = TraversalWorkspace::get_thread_workspace(0);
+  auto& backward_workspace = TraversalWorkspace::get_thread_workspace(1);
+  forward_workspace.reset(vertices_count);
+  backward_workspace.reset(vertices_count);
+  forward_workspace.reach(source_vertex_id, INVALID_ID, 0);
+  backward_workspace.reach(destination_vertex_id, INVALID_ID, 0);
+  const auto& forward_queue = forward_workspace.get_vertices_queue();
+  const auto& backward_queue = backward_workspace.get_vertices_queue();
+  int forward_frontier_begin = 0;
+  int backward_frontier_begin = 0;
+
+  while (forward_frontier_begin < static_cast<int>(forward_queue.size()) &&
+         backward_frontier_begin < static_cast<int>(backward_queue.size())) {
+    const bool is_forward =
+        forward_queue.size() - forward_frontier_begin <=
+        backward_queue.size() - backward_frontier_begin;
+    auto& workspace = is_forward ? forward_workspace : backward_workspace;
+    const auto& other_workspace =
+        is_forward ? backward_workspace : forward_workspace;
+    const auto& vertices_queue = workspace.get_vertices_queue();
+    int& frontier_begin =
+        is_forward ? forward_frontier_begin : backward_frontier_begin;
+    const int frontier_end = vertices_queue.size();
+
+    VertexId meeting_vertex_id = INVALID_ID;
+    Distance distance = 0;
+    for (int index = frontier_begin; index < frontier_end; index++) {
+      const auto current_vertex_id = vertices_queue[index];
+      const Distance next_distance =
+          workspace.get_distance(current_vertex_id) + 1;
+      const auto next_vertex_ids =
+          is_forward ? graph_.get_neighbor_ids(current_vertex_id)
+                     : graph_.get_predecessor_ids(current_vertex_id);
+      for (const auto& next_vertex_id : next_vertex_ids) {
+        if (workspace.is_reached(next_vertex_id))
+          continue;
+        workspace.reach(next_vertex_id, current_vertex_id, next_distance);
+        if (!other_workspace.is_reached(next_vertex_id))
+          continue;
+        const Distance meeting_distance =
+            next_distance + other_workspace.get_distance(next_vertex_id);
+        if (meeting_vertex_id == INVALID_ID || meeting_distance < distance) {
+          meeting_vertex_id = next_vertex_id;
+          distance = meeting_distance;
         }
       }
     }
+    frontier_begin = frontier_end;
+
+    if (meeting_vertex_id != INVALID_ID) {
+      // Forward parents lead back to the source, backward ones on to the
+      // destination.
+      std::vector<VertexId> vertex_ids(distance + 1);
+      int position = forward_workspace.get_distance(meeting_vertex_id);
+      for (VertexId vertex_id = meeting_vertex_id; vertex_id != INVALID_ID;
+           vertex_id = forward_workspace.get_parent_vertex_id(vertex_id))
+        vertex_ids[position--] = vertex_id;
+      position = forward_workspace.get_distance(meeting_vertex_id);
+      for (VertexId vertex_id = meeting_vertex_id; vertex_id != INVALID_ID;
+           vertex_id = backward_workspace.get_parent_vertex_id(vertex_id))
+        vertex_ids[position++] = vertex_id;
+      return Path(std::move(vertex_ids), distance);
+    }
   }
 
   throw std::logic_error("Vertices dont connected");
 }
 
-std::vector<GraphTraverser::Path> GraphTraverser::traverse_graph() {
-  std::list<std::function<void()>> jobs;
-  std::atomic<int> completed_jobs = 0;
-  std::mutex path_mutex;
-  const auto& vertex_ids = graph_.get_vertex_ids_at_depth(graph_.get_depth());
-  std::vector<GraphTraverser::Path> pathes;
-  pathes.reserve(vertex_ids.size());
-
-  for (const auto& vertex_id : vertex_ids)
-    jobs.emplace_back([this, &graph_ = graph_, &completed_jobs, &vertex_id,
-                       &pathes, &path_mutex]() {
-      auto path = find_shortest_path(graph_, 0, vertex_id);
-      {
-        std::lock_guard lock(path_mutex);
-        pathes.emplace_back(path);
-      }
-      completed_jobs++;
-    });
-
-  std::atomic<bool> should_terminate = false;
-  std::mutex jobs_mutex;
-  auto worker = [&should_terminate, &jobs_mutex, &jobs]() {
-    while (true) {
-      if (should_terminate) {
-        return;
+GraphTraverser::Path GraphTraverser::find_shortest_path_a_star(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id) const {
+  assert(graph_.is_vertex_exist(source_vertex_id));
+  assert(graph_.is_vertex_exist(destination_vertex_id));
+
+  if (graph_.get_max_depth_step() <= 0)
+    return find_shortest_path(source_vertex_id, destination_vertex_id);
+  const DepthEstimate get_depth_estimate(graph_, destination_vertex_id);
+  return search_a_star(graph_, source_vertex_id, destination_vertex_id,
+                       get_depth_estimate);
+}
+
+GraphTraverser::Path GraphTraverser::find_shortest_path_a_star(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id,
+    const LandmarkIndex& landmark_index) const {
+  assert(graph_.is_vertex_exist(source_vertex_id));
+  assert(graph_.is_vertex_exist(destination_vertex_id));
+
+  // Both estimates are consistent, and so is their maximum. Vertices the
+  // landmarks prove to have no path to the destination are never opened.
+  const DepthEstimate get_depth_estimate(graph_, destination_vertex_id);
+  const auto get_estimate = [&get_depth_estimate, &landmark_index,
+                             destination_vertex_id](const VertexId& vertex_id) {
+    const Distance lower_bound =
+        landmark_index.get_lower_bound(vertex_id, destination_vertex_id);
+    if (lower_bound == UNREACHABLE_DISTANCE)
+      return UNREACHABLE_DISTANCE;
+    return std::max(lower_bound, get_depth_estimate(vertex_id));
+  };
+  if (get_estimate(source_vertex_id) == UNREACHABLE_DISTANCE)
+    throw std::logic_error("Vertices dont connected");
+  return search_a_star(graph_, source_vertex_id, destination_vertex_id,
+                       get_estimate);
+}
+
+GraphTraverser::Path GraphTraverser::find_lightest_path(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id,
+    const ColorWeights& color_weights) const {
+  assert(graph_.is_vertex_exist(source_vertex_id));
+  assert(graph_.is_vertex_exist(destination_vertex_id));
+  assert(std::all_of(color_weights.begin(), color_weights.end(),
+                     [](Distance weight) { return weight >= 0; }));
+
+  // Dial's algorithm: every open vertex is at most the largest weight away
+  // from the current distance, so a ring of that many buckets plus one
+  // never mixes two distances in one bucket. An entry is stale once its
+  // vertex got a shorter distance.
+  const int buckets_count =
+      *std::max_element(color_weights.begin(), color_weights.end()) + 1;
+  std::vector<std::vector<VertexId>> buckets(buckets_count);
+  auto& workspace = TraversalWorkspace::get_thread_workspace();
+  workspace.reset(graph_.get_vertices_count());
+  workspace.reach(source_vertex_id, INVALID_ID, 0);
+  buckets[0].push_back(source_vertex_id);
+  int open_vertices_count = 1;
+
+  for (Distance distance = 0; open_vertices_count > 0; distance++) {
+    auto& bucket = buckets[distance % buckets_count];
+    while (!bucket.empty()) {
+      const auto current_vertex_id = bucket.back();
+      bucket.pop_back();
+      open_vertices_count--;
+      if (workspace.get_distance(current_vertex_id) != distance)
+        continue;
+      if (current_vertex_id == destination_vertex_id)
+        return restore_path(workspace, destination_vertex_id);
+
+      const auto next_vertex_ids = graph_.get_neighbor_ids(current_vertex_id);
+      const auto colors = graph_.get_neighbor_colors(current_vertex_id);
+      for (std::size_t index = 0; index < next_vertex_ids.size(); index++) {
+        const auto next_vertex_id = next_vertex_ids[index];
+        const Distance next_distance =
+            distance + color_weights[static_cast<int>(colors[index])];
+        if (!workspace.is_reached(next_vertex_id))
+          workspace.reach(next_vertex_id, current_vertex_id, next_distance);
+        else if (next_distance < workspace.get_distance(next_vertex_id))
+          workspace.improve(next_vertex_id, current_vertex_id, next_distance);
+        else
+          continue;
+        buckets[next_distance % buckets_count].push_back(next_vertex_id);
+        open_vertices_count++;
       }
-      const auto job_optional =
-          [&jobs_mutex, &jobs]() -> std::optional<std::function<void()>> {
-        const std::lock_guard lock(jobs_mutex);
-        if (jobs.empty()) {
-          return std::nullopt;
-        }
-        const auto job = jobs.front();
-        jobs.pop_front();
-        return job;
-      }();
-      if (job_optional.has_value()) {
-        const auto& job = job_optional.value();
-        job();
+    }
+  }
+
+  throw std::logic_error("Vertices dont connected");
+}
+
+std::vector<GraphTraverser::Path> GraphTraverser::find_shortest_paths(
+    const VertexId& source_vertex_id,
+    const std::vector<VertexId>& destination_vertex_ids) const {
+  assert(graph_.is_vertex_exist(source_vertex_id));
+
+  const int vertices_count = graph_.get_vertices_count();
+  if (vertices_count >= MIN_PARALLEL_SEARCH_VERTICES_COUNT &&
+      ThreadPool::get_thread_pool().get_workers_count() > 1) {
+    // The thread workspace is not used here: while waiting for the pool
+    // this thread may run another search that resets it.
+    std::vector<bool> is_destination(vertices_count, false);
+    int destinations_count = 0;
+    for (const auto& vertex_id : destination_vertex_ids) {
+      assert(graph_.is_vertex_exist(vertex_id));
+      if (!is_destination[vertex_id]) {
+        is_destination[vertex_id] = true;
+        destinations_count++;
       }
     }
-  };
 
-  const auto threads_number = std::min(vertex_ids.size(), MAX_WORKERS_COUNT);
-  auto threads = std::vector<std::thread>();
-  threads.reserve(threads_number);
+    ConcurrentSearchTree tree(vertices_count);
+    search_in_parallel(graph_, source_vertex_id, is_destination,
+                       destinations_count, tree);
+    return restore_pathes(tree, destination_vertex_ids);
+  }
 
-  for (int i = 0; i < threads_number; ++i) {
-    threads.emplace_back(worker);
+  auto& workspace = TraversalWorkspace::get_thread_workspace();
+  workspace.reset(vertices_count);
+  int destinations_count = 0;
+  for (const auto& vertex_id : destination_vertex_ids) {
+    assert(graph_.is_vertex_exist(vertex_id));
+    if (workspace.mark_destination(vertex_id))
+      destinations_count++;
   }
 
-  while (completed_jobs != vertex_ids.size()) {
+  search(graph_, source_vertex_id, destinations_count, workspace);
+  return restore_pathes(workspace, destination_vertex_ids);
+}
+
+std::vector<std::vector<GraphTraverser::Distance>>
+GraphTraverser::find_distances(
+    const std::vector<VertexId>& source_vertex_ids,
+    const std::vector<VertexId>& destination_vertex_ids) const {
+  // Repeated destinations are searched for once and copied at the end.
+  std::vector<int> destination_columns(graph_.get_vertices_count(), INVALID_ID);
+  std::vector<VertexId> column_vertex_ids;
+  for (int column = 0; column < static_cast<int>(destination_vertex_ids.size());
+       column++) {
+    const auto vertex_id = destination_vertex_ids[column];
+    assert(graph_.is_vertex_exist(vertex_id));
+    if (destination_columns[vertex_id] == INVALID_ID) {
+      destination_columns[vertex_id] = column;
+      column_vertex_ids.push_back(vertex_id);
+    }
   }
 
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
+  std::vector<std::vector<Distance>> distances(
+      source_vertex_ids.size(),
+      std::vector<Distance>(destination_vertex_ids.size(),
+                            UNREACHABLE_DISTANCE));
+  const int batches_count =
+      (source_vertex_ids.size() + SOURCES_BATCH_SIZE - 1) / SOURCES_BATCH_SIZE;
+  const std::int64_t masks_bytes = std::max<std::int64_t>(
+      1, graph_.get_vertices_count() * std::int64_t(3 * sizeof(std::uint64_t)));
+  const int max_parallel_batches_count =
+      std::max<std::int64_t>(1, MAX_BATCH_MASKS_BYTES / masks_bytes);
+  const int min_part_size =
+      (batches_count + max_parallel_batches_count - 1) /
+      max_parallel_batches_count;
+  ThreadPool::get_thread_pool().run_in_parallel(
+      batches_count, min_part_size,
+      [this, &source_vertex_ids, &destination_columns, &column_vertex_ids,
+       &distances](int begin, int end) {
+        BatchMasks masks(graph_.get_vertices_count());
+        for (int batch = begin; batch < end; batch++)
+          find_batch_distances(graph_, source_vertex_ids,
+                               batch * SOURCES_BATCH_SIZE, destination_columns,
+                               column_vertex_ids, masks, distances);
+      });
+
+  for (int column = 0; column < static_cast<int>(destination_vertex_ids.size());
+       column++) {
+    const int searched_column =
+        destination_columns[destination_vertex_ids[column]];
+    if (searched_column != column)
+      for (auto& row : distances)
+        row[column] = row[searched_column];
   }
+  return distances;
+}
 
-  return pathes;
+std::vector<GraphTraverser::Path> GraphTraverser::traverse_graph() {
+  const auto vertex_ids = graph_.get_vertex_ids_at_depth(graph_.get_depth());
+  return find_shortest_paths(
+      0, std::vector<VertexId>(vertex_ids.begin(), vertex_ids.end()));
 }
 
 }  // namespace uni_cpp_practice
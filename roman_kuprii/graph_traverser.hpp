@@ -1,36 +1,77 @@
 #pragma once
 
+#include <array>
 #include <mutex>
 #include <optional>
+#include <utility>
 #include <vector>
 
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 
 namespace uni_cpp_practice {
 
-class Graph;
+class LandmarkIndex;
 
 class GraphTraverser {
  public:
   using Distance = int;
 
+  static constexpr Distance UNREACHABLE_DISTANCE = -1;
+
+  // Non-negative cost of walking an edge, indexed by its color.
+  using ColorWeights = std::array<Distance, Edge::COLORS_COUNT>;
+
   struct Path {
     Path(std::vector<VertexId> _vertex_ids, Distance _distance)
-        : vertex_ids(_vertex_ids), distance(_distance) {}
+        : vertex_ids(std::move(_vertex_ids)), distance(_distance) {}
     std::vector<VertexId> vertex_ids;
     Distance distance = 0;
   };
 
   std::vector<Path> traverse_graph();
 
-  Path find_shortest_path(const Graph& graph,
-                          const VertexId& source_vertex_id,
+  Path find_shortest_path(const VertexId& source_vertex_id,
                           const VertexId& destination_vertex_id) const;
 
-  GraphTraverser(const Graph& graph) : graph_(graph) {}
+  // Same as find_shortest_path(), but searches A* style, guided by how many
+  // layers are left to the destination. Falls back to find_shortest_path()
+  // on graphs with no edge going deeper.
+  Path find_shortest_path_a_star(const VertexId& source_vertex_id,
+                                 const VertexId& destination_vertex_id) const;
+
+  // Same, with the landmark lower bound as a second estimate. Prunes every
+  // vertex the landmarks prove to have no path to the destination.
+  Path find_shortest_path_a_star(const VertexId& source_vertex_id,
+                                 const VertexId& destination_vertex_id,
+                                 const LandmarkIndex& landmark_index) const;
+
+  // Path of the least total weight, which is its distance. Weights are
+  // small integers, so the open set is a ring of buckets, one per distance
+  // within the largest weight of the current one.
+  Path find_lightest_path(const VertexId& source_vertex_id,
+                          const VertexId& destination_vertex_id,
+                          const ColorWeights& color_weights) const;
+
+  // Shortest paths to every destination, in the same order, found with a
+  // single search from the source.
+  std::vector<Path> find_shortest_paths(
+      const VertexId& source_vertex_id,
+      const std::vector<VertexId>& destination_vertex_ids) const;
+
+  // Matrix of shortest distances with a row per source and a column per
+  // destination, UNREACHABLE_DISTANCE where there is no path. Sources are
+  // searched 64 at a time, one bit of a machine word each. A batch running
+  // on a worker holds 24 bytes per vertex, and fewer batches run at once
+  // when the workers would need more than 1 GiB in total.
+  std::vector<std::vector<Distance>> find_distances(
+      const std::vector<VertexId>& source_vertex_ids,
+      const std::vector<VertexId>& destination_vertex_ids) const;
+
+  GraphTraverser(const FrozenGraph& graph) : graph_(graph) {}
 
  private:
-  const Graph& graph_;
+  const FrozenGraph& graph_;
 };
 
 }  // namespace uni_cpp_practice
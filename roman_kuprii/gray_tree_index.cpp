@@ -0,0 +1,124 @@
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+#include "graph_traverser.hpp"
+#include "gray_tree_index.hpp"
+
+namespace uni_cpp_practice {
+
+namespace {
+
+int get_log2(int value) {
+  return 31 - __builtin_clz(value);
+}
+
+}  // namespace
+
+GrayTreeIndex::GrayTreeIndex(const FrozenGraph& graph)
+    : max_depth_step_(graph.get_max_depth_step()) {
+  const int vertices_count = graph.get_vertices_count();
+  if (vertices_count == 0)
+    return;
+
+  depths_.reserve(vertices_count);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++)
+    depths_.push_back(graph.get_vertex_depth(vertex_id));
+
+  // Preorder walk of the gray edges from the root, remembering parents.
+  std::vector<VertexId> parent_ids(vertices_count, INVALID_ID);
+  std::vector<VertexId> order;
+  order.reserve(vertices_count);
+  positions_.assign(vertices_count, INVALID_ID);
+  std::vector<VertexId> vertices_stack = {0};
+  while (!vertices_stack.empty()) {
+    const auto vertex_id = vertices_stack.back();
+    vertices_stack.pop_back();
+    positions_[vertex_id] = order.size();
+    order.push_back(vertex_id);
+    const auto neighbor_ids = graph.get_neighbor_ids(vertex_id);
+    const auto neighbor_colors = graph.get_neighbor_colors(vertex_id);
+    for (std::size_t index = 0; index < neighbor_ids.size(); index++)
+      if (neighbor_colors[index] == Edge::Color::Gray) {
+        parent_ids[neighbor_ids[index]] = vertex_id;
+        vertices_stack.push_back(neighbor_ids[index]);
+      }
+  }
+  assert(static_cast<int>(order.size()) == vertices_count);
+
+  // The lowest common ancestor of u and v at earlier and later positions
+  // is the parent of least depth among the vertices at positions (u, v]:
+  // the walk leaves u's subtree only through the ancestor's child holding
+  // v, or stays within the subtree if u itself is the ancestor.
+  const int levels_count = get_log2(vertices_count) + 1;
+  min_depth_parent_ids_.resize(levels_count);
+  min_depth_parent_ids_[0].reserve(vertices_count);
+  // The root stands in for its own parent, never asked for by a query.
+  parent_ids[0] = 0;
+  for (const auto& vertex_id : order)
+    min_depth_parent_ids_[0].push_back(parent_ids[vertex_id]);
+  for (int level = 1; level < levels_count; level++) {
+    const auto& previous = min_depth_parent_ids_[level - 1];
+    auto& current = min_depth_parent_ids_[level];
+    const int half = 1 << (level - 1);
+    current.reserve(vertices_count - 2 * half + 1);
+    for (int position = 0; position + 2 * half <= vertices_count; position++) {
+      const auto& left_id = previous[position];
+      const auto& right_id = previous[position + half];
+      current.push_back(depths_[right_id] < depths_[left_id] ? right_id
+                                                              : left_id);
+    }
+  }
+}
+
+VertexId GrayTreeIndex::get_lowest_common_ancestor_id(
+    const VertexId& first_vertex_id,
+    const VertexId& second_vertex_id) const {
+  if (first_vertex_id == second_vertex_id)
+    return first_vertex_id;
+  int begin = positions_[first_vertex_id];
+  int end = positions_[second_vertex_id];
+  if (begin > end)
+    std::swap(begin, end);
+  begin++;
+  end++;
+  const int level = get_log2(end - begin);
+  const auto& left_id = min_depth_parent_ids_[level][begin];
+  const auto& right_id = min_depth_parent_ids_[level][end - (1 << level)];
+  return depths_[right_id] < depths_[left_id] ? right_id : left_id;
+}
+
+GrayTreeIndex::Distance GrayTreeIndex::get_tree_distance(
+    const VertexId& first_vertex_id,
+    const VertexId& second_vertex_id) const {
+  const auto ancestor_id =
+      get_lowest_common_ancestor_id(first_vertex_id, second_vertex_id);
+  return depths_[first_vertex_id] + depths_[second_vertex_id] -
+         2 * depths_[ancestor_id];
+}
+
+GrayTreeIndex::Distance GrayTreeIndex::get_upper_bound(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id) const {
+  if (get_lowest_common_ancestor_id(source_vertex_id,
+                                    destination_vertex_id) != source_vertex_id)
+    return GraphTraverser::UNREACHABLE_DISTANCE;
+  return depths_[destination_vertex_id] - depths_[source_vertex_id];
+}
+
+std::optional<GrayTreeIndex::Distance> GrayTreeIndex::find_exact_distance(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id) const {
+  const Distance upper_bound =
+      get_upper_bound(source_vertex_id, destination_vertex_id);
+  if (upper_bound == GraphTraverser::UNREACHABLE_DISTANCE ||
+      (upper_bound > 0 && max_depth_step_ > 1))
+    return std::nullopt;
+  return upper_bound;
+}
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+#include "graph_traverser.hpp"
+
+namespace uni_cpp_practice {
+
+// Lowest common ancestors in the tree of gray edges, which connect every
+// vertex to its parent one layer up. Answers in O(1) with a sparse table
+// of minimum depths over the vertices in depth first order, built in
+// O(V log V).
+class GrayTreeIndex {
+ public:
+  using Distance = GraphTraverser::Distance;
+
+  explicit GrayTreeIndex(const FrozenGraph& graph);
+
+  VertexId get_lowest_common_ancestor_id(
+      const VertexId& first_vertex_id,
+      const VertexId& second_vertex_id) const;
+
+  // Edges in the tree between the vertices, whatever their direction.
+  Distance get_tree_distance(const VertexId& first_vertex_id,
+                             const VertexId& second_vertex_id) const;
+
+  // Length of the gray path, which only exists from an ancestor down to
+  // its descendant, UNREACHABLE_DISTANCE otherwise.
+  Distance get_upper_bound(const VertexId& source_vertex_id,
+                           const VertexId& destination_vertex_id) const;
+
+  // The gray path length when no path can be shorter: no edge goes more
+  // than one layer deeper, so every path spends an edge per layer.
+  std::optional<Distance> find_exact_distance(
+      const VertexId& source_vertex_id,
+      const VertexId& destination_vertex_id) const;
+
+ private:
+  const int max_depth_step_;
+  std::vector<int> depths_;
+  std::vector<int> positions_;
+  // Row k holds, for every position i, the parent of least depth among the
+  // vertices at positions [i, i + 2^k) of the depth first order.
+  std::vector<std::vector<VertexId>> min_depth_parent_ids_;
+};
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+#include "graph_traverser.hpp"
+#include "landmark_index.hpp"
+#include "thread_pool.hpp"
+
+namespace uni_cpp_practice {
+
+namespace {
+
+using Distance = LandmarkIndex::Distance;
+
+constexpr Distance UNREACHABLE_DISTANCE = GraphTraverser::UNREACHABLE_DISTANCE;
+
+// Breadth first search from the landmark along the edges, or against them
+// when searching for distances to it.
+std::vector<Distance> find_landmark_distances(const FrozenGraph& graph,
+                                              const VertexId& landmark_id,
+                                              bool is_reversed) {
+  std::vector<Distance> distances(graph.get_vertices_count(),
+                                  UNREACHABLE_DISTANCE);
+  std::vector<VertexId> vertices_queue = {landmark_id};
+  distances[landmark_id] = 0;
+  for (std::size_t index = 0; index < vertices_queue.size(); index++) {
+    const auto vertex_id = vertices_queue[index];
+    const auto next_vertex_ids = is_reversed
+                                     ? graph.get_predecessor_ids(vertex_id)
+                                     : graph.get_neighbor_ids(vertex_id);
+    for (const auto& next_vertex_id : next_vertex_ids) {
+      if (distances[next_vertex_id] != UNREACHABLE_DISTANCE)
+        continue;
+      distances[next_vertex_id] = distances[vertex_id] + 1;
+      vertices_queue.push_back(next_vertex_id);
+    }
+  }
+  return distances;
+}
+
+}  // namespace
+
+LandmarkIndex::LandmarkIndex(const FrozenGraph& graph, int landmarks_count) {
+  assert(landmarks_count > 0);
+  const int vertices_count = graph.get_vertices_count();
+  if (vertices_count == 0)
+    return;
+
+  // Picking the next landmark needs the distances from the previous ones,
+  // so the forward searches go one by one. A deepest vertex unreachable
+  // from every landmark so far counts as the farthest one.
+  std::vector<std::vector<Distance>> distances_from;
+  std::vector<Distance> min_distances(vertices_count,
+                                      std::numeric_limits<Distance>::max());
+  VertexId landmark_id = 0;
+  while (true) {
+    landmark_ids_.push_back(landmark_id);
+    distances_from.push_back(
+        find_landmark_distances(graph, landmark_id, false));
+    for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++)
+      if (distances_from.back()[vertex_id] != UNREACHABLE_DISTANCE)
+        min_distances[vertex_id] = std::min(min_distances[vertex_id],
+                                            distances_from.back()[vertex_id]);
+    if (static_cast<int>(landmark_ids_.size()) == landmarks_count)
+      break;
+
+    landmark_id = INVALID_ID;
+    for (const auto& vertex_id :
+         graph.get_vertex_ids_at_depth(graph.get_depth())) {
+      if (min_distances[vertex_id] == 0)
+        continue;
+      if (landmark_id == INVALID_ID ||
+          min_distances[vertex_id] > min_distances[landmark_id] ||
+          (min_distances[vertex_id] == min_distances[landmark_id] &&
+           vertex_id < landmark_id))
+        landmark_id = vertex_id;
+    }
+    if (landmark_id == INVALID_ID)
+      break;
+  }
+
+  const int count = landmark_ids_.size();
+  std::vector<std::vector<Distance>> distances_to(count);
+  ThreadPool::get_thread_pool().run_in_parallel(
+      count, 1, [this, &graph, &distances_to](int begin, int end) {
+        for (int index = begin; index < end; index++)
+          distances_to[index] =
+              find_landmark_distances(graph, landmark_ids_[index], true);
+      });
+
+  distances_from_landmarks_.resize(vertices_count * count);
+  distances_to_landmarks_.resize(vertices_count * count);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; vertex_id++)
+    for (int index = 0; index < count; index++) {
+      distances_from_landmarks_[vertex_id * count + index] =
+          distances_from[index][vertex_id];
+      distances_to_landmarks_[vertex_id * count + index] =
+          distances_to[index][vertex_id];
+    }
+}
+
+Distance LandmarkIndex::get_lower_bound(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id) const {
+  const int count = landmark_ids_.size();
+  const Distance* const source_from =
+      distances_from_landmarks_.data() + source_vertex_id * count;
+  const Distance* const source_to =
+      distances_to_landmarks_.data() + source_vertex_id * count;
+  const Distance* const destination_from =
+      distances_from_landmarks_.data() + destination_vertex_id * count;
+  const Distance* const destination_to =
+      distances_to_landmarks_.data() + destination_vertex_id * count;
+
+  // d(s, t) >= d(L, t) - d(L, s) and d(s, t) >= d(s, L) - d(t, L). With the
+  // subtrahend finite, an infinite minuend means t can't be reached from s.
+  Distance lower_bound = 0;
+  for (int index = 0; index < count; index++) {
+    if (source_from[index] != UNREACHABLE_DISTANCE) {
+      if (destination_from[index] == UNREACHABLE_DISTANCE)
+        return UNREACHABLE_DISTANCE;
+      lower_bound = std::max(lower_bound,
+                             destination_from[index] - source_from[index]);
+    }
+    if (destination_to[index] != UNREACHABLE_DISTANCE) {
+      if (source_to[index] == UNREACHABLE_DISTANCE)
+        return UNREACHABLE_DISTANCE;
+      lower_bound =
+          std::max(lower_bound, source_to[index] - destination_to[index]);
+    }
+  }
+  return lower_bound;
+}
+
+Distance LandmarkIndex::get_upper_bound(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id) const {
+  const int count = landmark_ids_.size();
+  const Distance* const source_to =
+      distances_to_landmarks_.data() + source_vertex_id * count;
+  const Distance* const destination_from =
+      distances_from_landmarks_.data() + destination_vertex_id * count;
+
+  Distance upper_bound = UNREACHABLE_DISTANCE;
+  for (int index = 0; index < count; index++) {
+    if (source_to[index] == UNREACHABLE_DISTANCE ||
+        destination_from[index] == UNREACHABLE_DISTANCE)
+      continue;
+    const Distance distance = source_to[index] + destination_from[index];
+    if (upper_bound == UNREACHABLE_DISTANCE || distance < upper_bound)
+      upper_bound = distance;
+  }
+  return upper_bound;
+}
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+#include "graph_traverser.hpp"
+
+namespace uni_cpp_practice {
+
+// Shortest distances from and to a few landmark vertices of a graph, built
+// once and shared by any number of queries on it. The triangle inequality
+// turns them into bounds on the distance between any two vertices in
+// O(landmarks count), with no search at all. Landmarks are the root and
+// then the deepest vertices farthest from the ones already picked.
+class LandmarkIndex {
+ public:
+  using Distance = GraphTraverser::Distance;
+
+  LandmarkIndex(const FrozenGraph& graph, int landmarks_count);
+
+  const std::vector<VertexId>& get_landmark_ids() const {
+    return landmark_ids_;
+  }
+
+  // Never exceeds the shortest distance. UNREACHABLE_DISTANCE when the
+  // landmarks prove there is no path at all.
+  Distance get_lower_bound(const VertexId& source_vertex_id,
+                           const VertexId& destination_vertex_id) const;
+
+  // Length of the shortest path through a landmark, which is never shorter
+  // than the shortest distance. UNREACHABLE_DISTANCE when no landmark lies
+  // on a path between the vertices.
+  Distance get_upper_bound(const VertexId& source_vertex_id,
+                           const VertexId& destination_vertex_id) const;
+
+ private:
+  std::vector<VertexId> landmark_ids_;
+  // Vertex major, the distances of a vertex to or from every landmark are
+  // next to each other.
+  std::vector<Distance> distances_from_landmarks_;
+  std::vector<Distance> distances_to_landmarks_;
+};
+
+}  // namespace uni_cpp_practice
@@ -1,5 +1,6 @@
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <optional>
 #include <string>
 
@@ -28,6 +29,7 @@ void Logger::set_output(const std::optional<std::string>& file_path) {
 }
 
 void Logger::log(const std::string& text) {
+  const std::lock_guard lock(mutex_);
   std::cout << text << std::endl;
   if (file_stream_.has_value())
     file_stream_.value() << text << std::endl;
@@ -1,5 +1,7 @@
 #include <array>
 #include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -8,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 #include "graph_printing.hpp"
 #include "graph_traverser.hpp"
@@ -22,9 +25,10 @@ using std::to_string;
 std::string get_datetime() {
   const auto date_time = std::chrono::system_clock::now();
   const auto date_time_t = std::chrono::system_clock::to_time_t(date_time);
+  std::tm local_date_time;
+  localtime_r(&date_time_t, &local_date_time);
   std::stringstream date_time_string;
-  date_time_string << std::put_time(std::localtime(&date_time_t),
-                                    "%Y.%m.%d %H:%M:%S");
+  date_time_string << std::put_time(&local_date_time, "%Y.%m.%d %H:%M:%S");
   return date_time_string.str();
 }
 
@@ -34,7 +38,7 @@ namespace uni_cpp_practice {
 
 namespace logging_helping {
 
-void write_graph(const Graph& graph, int graph_num) {
+void write_graph(const FrozenGraph& graph, int graph_num) {
   std::ofstream out;
   const std::string filename =
       JSON_GRAPH_FILENAME + std::to_string(graph_num) + ".json";
@@ -43,17 +47,24 @@ void write_graph(const Graph& graph, int graph_num) {
   out.close();
 }
 
+std::string write_generation_params(std::uint64_t seed, bool deterministic) {
+  std::string res = get_datetime();
+  res += ": Generation Params {seed: " + to_string(seed) +
+         ", deterministic: " + (deterministic ? "true" : "false") + "}";
+  return res;
+}
+
 std::string write_log_start(int graph_num) {
   std::string res = get_datetime();
   res += ": Graph " + to_string(graph_num) + ", Generation Started";
   return res;
 }
 
-std::string write_log_end(const Graph& work_graph, int graph_num) {
+std::string write_log_end(const FrozenGraph& work_graph, int graph_num) {
   std::string res = get_datetime();
   res += ": Graph " + to_string(graph_num) + ", Generation Ended {\n";
   res += "  depth: " + to_string(work_graph.get_depth()) + ",\n";
-  res += "  vertices: " + to_string(work_graph.get_vertices().size()) + ", [";
+  res += "  vertices: " + to_string(work_graph.get_vertices_count()) + ", [";
 
   for (int depth = 0; depth <= work_graph.get_depth(); depth++) {
     res += to_string(work_graph.get_vertex_ids_at_depth(depth).size()) + ", ";
@@ -61,7 +72,7 @@ std::string write_log_end(const Graph& work_graph, int graph_num) {
   res.pop_back();
   res.pop_back();
   res += "],\n";
-  res += "  edges: " + to_string(work_graph.get_edges().size()) + ", {";
+  res += "  edges: " + to_string(work_graph.get_edges_count()) + ", {";
 
   const auto colors = std::vector<Edge::Color>(
       {Edge::Color::Gray, Edge::Color::Green, Edge::Color::Blue,
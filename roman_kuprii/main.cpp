@@ -1,8 +1,17 @@
+#include <charconv>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <random>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 #include "graph_generation_controller.hpp"
 #include "graph_generator.hpp"
@@ -18,9 +27,19 @@ constexpr int INVALID_NEW_VERTICES_NUMBER = -1;
 constexpr int INVALID_THREADS_NUMBER = 0;
 const std::string LOG_FILENAME = "temp/log.txt";
 const std::string DIRECTORY_NAME = "temp";
+const std::string PIPELINE_FLAG = "--pipeline";
+const std::string SEED_FLAG = "--seed";
+const std::string DETERMINISTIC_FLAG = "--deterministic";
+const std::string USAGE =
+    "Usage: prog [--pipeline [max_unreleased_graphs]] [--seed seed] "
+    "[--deterministic]";
+// Graphs per thread allowed to wait for traversal in the pipeline mode,
+// unless the limit is given after PIPELINE_FLAG.
+constexpr int UNRELEASED_GRAPHS_PER_THREAD = 2;
 
 const int MAX_THREADS_COUNT = std::thread::hardware_concurrency();
 
+using uni_cpp_practice::FrozenGraph;
 using uni_cpp_practice::Graph;
 using uni_cpp_practice::GraphGenerator;
 using uni_cpp_practice::GraphTraverser;
@@ -28,6 +47,53 @@ using uni_cpp_practice::Logger;
 using uni_cpp_practice::graph_generation_controller::GraphGenerationController;
 using uni_cpp_practice::graph_traversal_controller::GraphTraversalController;
 
+struct Options {
+  bool is_pipeline = false;
+  std::optional<int> max_unreleased_graphs;
+  std::optional<std::uint64_t> seed;
+  bool deterministic = false;
+};
+
+// Whole argument as a number, std::nullopt if it is anything else.
+template <typename T>
+std::optional<T> parse_number(const std::string& text) {
+  T value = 0;
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc() || end != text.data() + text.size())
+    return std::nullopt;
+  return value;
+}
+
+// std::nullopt on an unknown flag or a malformed value.
+std::optional<Options> parse_options(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const std::string argument = argv[i];
+    if (argument == PIPELINE_FLAG) {
+      options.is_pipeline = true;
+      // The limit is optional, the default one is picked by threads count.
+      if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+        options.max_unreleased_graphs = parse_number<int>(argv[++i]);
+        if (!options.max_unreleased_graphs.has_value() ||
+            options.max_unreleased_graphs.value() <= 0)
+          return std::nullopt;
+      }
+    } else if (argument == SEED_FLAG) {
+      if (i + 1 == argc)
+        return std::nullopt;
+      options.seed = parse_number<std::uint64_t>(argv[++i]);
+      if (!options.seed.has_value())
+        return std::nullopt;
+    } else if (argument == DETERMINISTIC_FLAG) {
+      options.deterministic = true;
+    } else {
+      return std::nullopt;
+    }
+  }
+  return options;
+}
+
 int handle_graphs_number_input() {
   int graphs_quantity = GRAPHS_NUMBER;
   do {
@@ -70,11 +136,12 @@ void prepare_temp_directory() {
   std::filesystem::create_directory(DIRECTORY_NAME);
 }
 
-std::vector<Graph> generate_graphs(Logger& logger,
-                                   const int threads_count,
-                                   const int graphs_count,
-                                   const GraphGenerator::Params& params) {
-  auto graphs = std::vector<Graph>();
+// Keeps only the frozen snapshots, the graphs are read only from here on.
+std::vector<FrozenGraph> generate_graphs(Logger& logger,
+                                         const int threads_count,
+                                         const int graphs_count,
+                                         const GraphGenerator::Params& params) {
+  auto graphs = std::vector<FrozenGraph>();
   graphs.reserve(graphs_count);
 
   auto generation_controller =
@@ -83,17 +150,18 @@ std::vector<Graph> generate_graphs(Logger& logger,
       [&logger](int index) {
         logger.log(uni_cpp_practice::logging_helping::write_log_start(index));
       },
-      [&logger, &graphs](const Graph& graph, int index) {
-        logger.log(
-            uni_cpp_practice::logging_helping::write_log_end(graph, index));
-        graphs.push_back(graph);
-        uni_cpp_practice::logging_helping::write_graph(graph, index);
+      [&logger, &graphs](Graph graph, int index) {
+        auto frozen_graph = graph.freeze();
+        logger.log(uni_cpp_practice::logging_helping::write_log_end(
+            frozen_graph, index));
+        uni_cpp_practice::logging_helping::write_graph(frozen_graph, index);
+        graphs.push_back(std::move(frozen_graph));
       });
 
   return graphs;
 }
 
-void traverse_graphs(const std::vector<Graph>& graphs,
+void traverse_graphs(const std::vector<FrozenGraph>& graphs,
                      Logger& logger,
                      const int threads_count) {
   auto traversal_controller = GraphTraversalController(threads_count, graphs);
@@ -108,7 +176,53 @@ void traverse_graphs(const std::vector<Graph>& graphs,
       });
 }
 
-int main() {
+// Traverses every graph as soon as it is generated. Generation pauses while
+// |max_unreleased_graphs| graphs are generated but not traversed yet, so
+// memory stays bounded however many graphs are requested.
+void generate_and_traverse_graphs(Logger& logger,
+                                  const int threads_count,
+                                  const int graphs_count,
+                                  const int max_unreleased_graphs,
+                                  const GraphGenerator::Params& params) {
+  auto generation_controller = GraphGenerationController(
+      threads_count, graphs_count, params, max_unreleased_graphs);
+  auto traversal_controller = GraphTraversalController(threads_count);
+  const auto traverse_started_callback = [&logger](int index) {
+    logger.log(uni_cpp_practice::logging_helping::write_traverse_start(index));
+  };
+  const auto traverse_finished_callback =
+      [&logger, &generation_controller](
+          int index, const std::vector<GraphTraverser::Path>& pathes) {
+        logger.log(uni_cpp_practice::logging_helping::write_traverse_end(
+            index, pathes));
+        generation_controller.release_graph();
+      };
+
+  generation_controller.generate(
+      [&logger](int index) {
+        logger.log(uni_cpp_practice::logging_helping::write_log_start(index));
+      },
+      [&logger, &traversal_controller, &traverse_started_callback,
+       &traverse_finished_callback](Graph graph, int index) {
+        auto frozen_graph = graph.freeze();
+        logger.log(uni_cpp_practice::logging_helping::write_log_end(
+            frozen_graph, index));
+        uni_cpp_practice::logging_helping::write_graph(frozen_graph, index);
+        traversal_controller.enqueue_graph(index, std::move(frozen_graph),
+                                           traverse_started_callback,
+                                           traverse_finished_callback);
+      });
+
+  traversal_controller.wait_enqueued_graphs();
+}
+
+int main(int argc, char** argv) {
+  const auto options = parse_options(argc, argv);
+  if (!options.has_value()) {
+    std::cerr << USAGE << std::endl;
+    return 1;
+  }
+
   auto& logger = Logger::get_logger();
   prepare_temp_directory();
   logger.set_output(LOG_FILENAME);
@@ -117,7 +231,21 @@ int main() {
   const int depth = handle_depth_input();
   const int new_vertices_num = handle_vertices_number_input();
   const int threads_count = handle_threads_number_input();
-  const auto params = GraphGenerator::Params(depth, new_vertices_num);
+  // An unset seed is still picked here, so that the log tells how to
+  // repeat the run.
+  const std::uint64_t seed = options->seed.value_or(std::random_device()());
+  logger.log(uni_cpp_practice::logging_helping::write_generation_params(
+      seed, options->deterministic));
+  const auto params = GraphGenerator::Params(depth, new_vertices_num, seed,
+                                             options->deterministic);
+
+  if (options->is_pipeline) {
+    const int max_unreleased_graphs = options->max_unreleased_graphs.value_or(
+        UNRELEASED_GRAPHS_PER_THREAD * threads_count);
+    generate_and_traverse_graphs(logger, threads_count, graphs_count,
+                                 max_unreleased_graphs, params);
+    return 0;
+  }
 
   auto graphs = generate_graphs(logger, threads_count, graphs_count, params);
   traverse_graphs(graphs, logger, threads_count);
@@ -0,0 +1,122 @@
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#include "random_generator.hpp"
+
+namespace {
+
+constexpr std::uint32_t PHILOX_M0 = 0xD2511F53;
+constexpr std::uint32_t PHILOX_M1 = 0xCD9E8D57;
+constexpr std::uint32_t PHILOX_W0 = 0x9E3779B9;
+constexpr std::uint32_t PHILOX_W1 = 0xBB67AE85;
+constexpr int PHILOX_ROUNDS = 10;
+
+std::uint64_t rotate_left(std::uint64_t value, int shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+double to_real(std::uint64_t bits) {
+  return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+int to_int(std::uint64_t bits, int upper_bound) {
+  assert(upper_bound >= 0);
+  const std::uint64_t range = static_cast<std::uint64_t>(upper_bound) + 1;
+  return static_cast<int>(((bits >> 32) * range) >> 32);
+}
+
+std::array<std::uint32_t, 4> philox_block(std::array<std::uint32_t, 4> counter,
+                                          std::array<std::uint32_t, 2> key) {
+  for (int round = 0; round < PHILOX_ROUNDS; round++) {
+    const std::uint64_t product0 =
+        static_cast<std::uint64_t>(PHILOX_M0) * counter[0];
+    const std::uint64_t product1 =
+        static_cast<std::uint64_t>(PHILOX_M1) * counter[2];
+    counter = {
+        static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+        static_cast<std::uint32_t>(product1),
+        static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+        static_cast<std::uint32_t>(product0)};
+    key[0] += PHILOX_W0;
+    key[1] += PHILOX_W1;
+  }
+  return counter;
+}
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+std::uint64_t splitmix64(std::uint64_t& state) {
+  std::uint64_t result = (state += 0x9e3779b97f4a7c15ULL);
+  result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  result = (result ^ (result >> 27)) * 0x94d049bb133111ebULL;
+  return result ^ (result >> 31);
+}
+
+std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t stream) {
+  std::uint64_t state = seed ^ splitmix64(stream);
+  return splitmix64(state);
+}
+
+RandomGenerator& RandomGenerator::get_thread_generator() {
+  thread_local RandomGenerator generator;
+  return generator;
+}
+
+void RandomGenerator::set_seed(std::uint64_t seed) {
+  for (auto& word : state_)
+    word = splitmix64(seed);
+}
+
+RandomGenerator::result_type RandomGenerator::operator()() {
+  const std::uint64_t result = rotate_left(state_[1] * 5, 7) * 9;
+  const std::uint64_t shifted = state_[1] << 17;
+
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= shifted;
+  state_[3] = rotate_left(state_[3], 45);
+
+  return result;
+}
+
+double RandomGenerator::get_real() {
+  return to_real((*this)());
+}
+
+int RandomGenerator::get_int(int upper_bound) {
+  return to_int((*this)(), upper_bound);
+}
+
+PhiloxGenerator::PhiloxGenerator(std::uint64_t seed,
+                                 std::uint32_t stream,
+                                 std::uint64_t key)
+    : key_({static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32)}),
+      counter_({0, stream, static_cast<std::uint32_t>(key),
+                static_cast<std::uint32_t>(key >> 32)}) {}
+
+PhiloxGenerator::result_type PhiloxGenerator::operator()() {
+  if (has_buffered_half_) {
+    has_buffered_half_ = false;
+    return (static_cast<std::uint64_t>(block_[3]) << 32) | block_[2];
+  }
+  block_ = philox_block(counter_, key_);
+  counter_[0]++;
+  has_buffered_half_ = true;
+  return (static_cast<std::uint64_t>(block_[1]) << 32) | block_[0];
+}
+
+double PhiloxGenerator::get_real() {
+  return to_real((*this)());
+}
+
+int PhiloxGenerator::get_int(int upper_bound) {
+  return to_int((*this)(), upper_bound);
+}
+
+}  // namespace uni_cpp_practice
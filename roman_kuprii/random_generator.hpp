@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace uni_cpp_practice {
+
+std::uint64_t splitmix64(std::uint64_t& state);
+
+// Seed of an independent stream derived from a base seed.
+std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t stream);
+
+// xoshiro256** pseudo random generator. 32 bytes of state, seeded in a few
+// instructions, so it is cheap enough to keep one per thread and reseed it
+// per job. Satisfies UniformRandomBitGenerator.
+class RandomGenerator {
+ public:
+  using result_type = std::uint64_t;
+
+  explicit RandomGenerator(std::uint64_t seed = 0) { set_seed(seed); }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return ~result_type(0); }
+
+  static RandomGenerator& get_thread_generator();
+
+  void set_seed(std::uint64_t seed);
+
+  result_type operator()();
+
+  // Uniform real number in [0, 1).
+  double get_real();
+
+  // Uniform integer number in [0, upper_bound].
+  int get_int(int upper_bound);
+
+ private:
+  std::array<std::uint64_t, 4> state_;
+};
+
+// Philox4x32-10 counter based generator. Output is a pure function of
+// (seed, stream, key, draw index), so a decision keyed by e.g. a vertex id
+// comes out the same no matter which thread makes it or in which order.
+class PhiloxGenerator {
+ public:
+  using result_type = std::uint64_t;
+
+  PhiloxGenerator(std::uint64_t seed, std::uint32_t stream, std::uint64_t key);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return ~result_type(0); }
+
+  result_type operator()();
+
+  // Uniform real number in [0, 1).
+  double get_real();
+
+  // Uniform integer number in [0, upper_bound].
+  int get_int(int upper_bound);
+
+ private:
+  std::array<std::uint32_t, 2> key_;
+  std::array<std::uint32_t, 4> counter_;
+  std::array<std::uint32_t, 4> block_ = {};
+  bool has_buffered_half_ = false;
+};
+
+// Index of the first success at or after |index| in a run of Bernoulli
+// trials with the given success probability, or |end| if there is none
+// before it. The gap to the next success is geometrically distributed, so
+// sparse passes draw one number per success instead of one per trial.
+template <typename Generator>
+int get_next_success_index(Generator& generator,
+                           double probability,
+                           int index,
+                           int end) {
+  const double skip = std::floor(std::log(1.0 - generator.get_real()) /
+                                 std::log1p(-probability));
+  return skip < end - index ? index + static_cast<int>(skip) : end;
+}
+
+}  // namespace uni_cpp_practice
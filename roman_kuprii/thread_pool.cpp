@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace {
+
+// Index of the pool worker running on this thread, if any.
+thread_local std::optional<int> current_worker_index = std::nullopt;
+
+}  // namespace
+
+namespace uni_cpp_practice {
+
+ThreadPool::ThreadPool()
+    : workers_count_(
+          std::max(1, static_cast<int>(std::thread::hardware_concurrency()))) {
+  for (int i = 0; i <= workers_count_; i++)
+    queues_.push_back(std::make_unique<JobQueue>());
+  threads_.reserve(workers_count_);
+  for (int i = 0; i < workers_count_; i++)
+    threads_.emplace_back([this, i]() { work(i); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard lock(idle_mutex_);
+    should_terminate_ = true;
+  }
+  has_jobs_.notify_all();
+  for (auto& thread : threads_)
+    thread.join();
+}
+
+void ThreadPool::submit(Job job) {
+  auto& queue = *queues_[current_worker_index.value_or(workers_count_)];
+  {
+    const std::lock_guard lock(queue.mutex);
+    queue.jobs.push_back(std::move(job));
+  }
+  bool has_waiters = false;
+  {
+    const std::lock_guard lock(idle_mutex_);
+    queued_jobs_count_++;
+    events_count_++;
+    has_waiters = waiters_count_ > 0;
+  }
+  has_jobs_.notify_one();
+  if (has_waiters)
+    state_changed_.notify_all();
+}
+
+std::optional<ThreadPool::Job> ThreadPool::take_job() {
+  const int queues_count = queues_.size();
+  const int own_index = current_worker_index.value_or(workers_count_);
+  if (current_worker_index.has_value()) {
+    auto& queue = *queues_[own_index];
+    const std::lock_guard lock(queue.mutex);
+    if (!queue.jobs.empty()) {
+      auto job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+      queued_jobs_count_--;
+      return job;
+    }
+  }
+  for (int shift = 1; shift <= queues_count; shift++) {
+    auto& queue = *queues_[(own_index + shift) % queues_count];
+    const std::lock_guard lock(queue.mutex);
+    if (!queue.jobs.empty()) {
+      auto job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+      queued_jobs_count_--;
+      return job;
+    }
+  }
+  return std::nullopt;
+}
+
+void ThreadPool::run_job(Job& job) {
+  job();
+  bool has_waiters = false;
+  {
+    const std::lock_guard lock(idle_mutex_);
+    events_count_++;
+    has_waiters = waiters_count_ > 0;
+  }
+  if (has_waiters)
+    state_changed_.notify_all();
+}
+
+void ThreadPool::work(int worker_index) {
+  current_worker_index = worker_index;
+  while (true) {
+    if (auto job = take_job(); job.has_value()) {
+      run_job(job.value());
+      continue;
+    }
+    std::unique_lock lock(idle_mutex_);
+    has_jobs_.wait(lock, [this]() {
+      return should_terminate_ || queued_jobs_count_ > 0;
+    });
+    if (should_terminate_)
+      return;
+  }
+}
+
+void ThreadPool::wait_until(const std::function<bool()>& is_done) {
+  while (true) {
+    // Read before checking, so an event in between is never slept through.
+    const std::uint64_t seen_events_count = events_count_;
+    if (is_done())
+      return;
+    if (auto job = take_job(); job.has_value()) {
+      run_job(job.value());
+      continue;
+    }
+    std::unique_lock lock(idle_mutex_);
+    waiters_count_++;
+    state_changed_.wait(lock, [this, seen_events_count]() {
+      return events_count_ != seen_events_count;
+    });
+    waiters_count_--;
+  }
+}
+
+void ThreadPool::run_in_parallel(int size,
+                                 int min_part_size,
+                                 const std::function<void(int, int)>& job) {
+  const int parts_count = std::max(
+      1, std::min(get_workers_count(), size / std::max(1, min_part_size)));
+  if (parts_count == 1) {
+    job(0, size);
+    return;
+  }
+  const int part_size = (size + parts_count - 1) / parts_count;
+  Latch parts_latch((size - 1) / part_size);
+  for (int begin = part_size; begin < size; begin += part_size) {
+    const int end = std::min(size, begin + part_size);
+    submit([&job, &parts_latch, begin, end]() {
+      job(begin, end);
+      parts_latch.count_down();
+    });
+  }
+  job(0, std::min(size, part_size));
+  wait(parts_latch);
+}
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace uni_cpp_practice {
+
+// Single use countdown of outstanding jobs, released when it reaches zero.
+// Jobs count it down as their last step and ThreadPool::wait blocks on it.
+class Latch {
+ public:
+  explicit Latch(int count) : count_(count) {}
+
+  void count_down() { count_--; }
+  bool is_released() const { return count_ == 0; }
+
+ private:
+  std::atomic<int> count_;
+};
+
+// Process-wide work stealing executor with one thread per hardware thread.
+// Every worker owns a deque: it takes its own jobs from the back and steals
+// from the front of the others. Jobs may submit more jobs and wait for
+// them. A waiting thread runs queued jobs meanwhile, so nested parallelism
+// never spawns threads of its own. Idle workers and waiters with nothing to
+// run sleep on condition variables instead of spinning.
+class ThreadPool {
+ public:
+  using Job = std::function<void()>;
+
+  static ThreadPool& get_thread_pool() {
+    static ThreadPool thread_pool;
+    return thread_pool;
+  }
+
+  int get_workers_count() const { return workers_count_; }
+
+  void submit(Job job);
+
+  // Runs queued jobs on the calling thread until |is_done| returns true.
+  // With nothing left to run it sleeps until a job is submitted or
+  // finished, so |is_done| must only change from inside pool jobs.
+  void wait_until(const std::function<bool()>& is_done);
+
+  void wait(const Latch& latch) {
+    wait_until([&latch]() { return latch.is_released(); });
+  }
+
+  // Splits [0, size) into contiguous parts of at least |min_part_size|,
+  // runs |job| on each part in parallel and waits for all of them.
+  void run_in_parallel(int size,
+                       int min_part_size,
+                       const std::function<void(int, int)>& job);
+
+  ~ThreadPool();
+
+ private:
+  struct JobQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  const int workers_count_;
+  // One queue per worker, plus a last one for jobs submitted from threads
+  // outside of the pool.
+  std::vector<std::unique_ptr<JobQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<int> queued_jobs_count_ = 0;
+  std::atomic<bool> should_terminate_ = false;
+  std::mutex idle_mutex_;
+  std::condition_variable has_jobs_;
+  // Bumped on every submitted and finished job, so a sleeping waiter
+  // re-checks its condition only when it may have changed.
+  std::atomic<std::uint64_t> events_count_ = 0;
+  int waiters_count_ = 0;
+  std::condition_variable state_changed_;
+
+  ThreadPool();
+  ThreadPool(const ThreadPool& root) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  std::optional<Job> take_job();
+  void run_job(Job& job);
+  void work(int worker_index);
+};
+
+}  // namespace uni_cpp_practice
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "traversal_workspace.hpp"
+
+namespace uni_cpp_practice {
+
+void StampedBitset::clear(int size) {
+  const std::size_t words_count = (size + 63) / 64;
+  if (words_.size() < words_count) {
+    words_.resize(words_count, 0);
+    word_epochs_.resize(words_count, 0);
+  }
+  if (++epoch_ == 0) {
+    std::fill(word_epochs_.begin(), word_epochs_.end(), 0);
+    epoch_ = 1;
+  }
+}
+
+int StampedBitset::find_next_unset(int index, int size) const {
+  int word_index = index >> 6;
+  std::uint64_t unset_bits = 0;
+  if (index < size) {
+    const std::uint64_t word =
+        word_epochs_[word_index] == epoch_ ? words_[word_index] : 0;
+    unset_bits = ~word & (~std::uint64_t(0) << (index & 63));
+  }
+  const int words_count = (size + 63) / 64;
+  while (unset_bits == 0 && ++word_index < words_count) {
+    unset_bits = word_epochs_[word_index] == epoch_ ? ~words_[word_index]
+                                                   : ~std::uint64_t(0);
+  }
+  if (unset_bits == 0)
+    return size;
+  return std::min(size, word_index * 64 + __builtin_ctzll(unset_bits));
+}
+
+TraversalWorkspace& TraversalWorkspace::get_thread_workspace(int index) {
+  assert(index >= 0 && index < THREAD_WORKSPACES_COUNT);
+  thread_local std::array<TraversalWorkspace, THREAD_WORKSPACES_COUNT>
+      workspaces;
+  return workspaces[index];
+}
+
+void TraversalWorkspace::reset(int vertices_count) {
+  vertices_count_ = vertices_count;
+  reached_.clear(vertices_count);
+  destinations_.clear(vertices_count);
+  if (static_cast<int>(parent_vertex_ids_.size()) < vertices_count) {
+    parent_vertex_ids_.resize(vertices_count);
+    distances_.resize(vertices_count);
+  }
+  vertices_queue_.clear();
+  vertices_queue_.reserve(vertices_count);
+}
+
+void TraversalWorkspace::set_frontier(int begin, int end) {
+  frontier_.clear(vertices_count_);
+  for (int index = begin; index < end; index++)
+    frontier_.set(vertices_queue_[index]);
+}
+
+}  // namespace uni_cpp_practice
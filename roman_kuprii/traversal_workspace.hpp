@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace uni_cpp_practice {
+
+// Bitset cleared in O(1) by bumping an epoch: a word stamped with an older
+// epoch reads as zero and is zeroed for real on its first write.
+class StampedBitset {
+ public:
+  // Clears the bitset and makes room for |size| bits.
+  void clear(int size);
+
+  bool test(int index) const {
+    const int word_index = index >> 6;
+    return word_epochs_[word_index] == epoch_ &&
+           ((words_[word_index] >> (index & 63)) & 1);
+  }
+
+  // First unset index at or after |index|, or |size| if there is none.
+  int find_next_unset(int index, int size) const;
+
+  void set(int index) {
+    const int word_index = index >> 6;
+    if (word_epochs_[word_index] != epoch_) {
+      word_epochs_[word_index] = epoch_;
+      words_[word_index] = 0;
+    }
+    words_[word_index] |= std::uint64_t(1) << (index & 63);
+  }
+
+ private:
+  std::vector<std::uint64_t> words_;
+  std::vector<std::uint32_t> word_epochs_;
+  std::uint32_t epoch_ = 0;
+};
+
+// Scratch memory of a breadth first search. A few are kept per thread and
+// reused across searches and graphs, so starting a search neither
+// allocates nor touches every vertex. Parents and distances are stale for
+// vertices not reached by the current search and must not be read.
+class TraversalWorkspace {
+ public:
+  static constexpr int THREAD_WORKSPACES_COUNT = 2;
+
+  // Searches running at the same time on one thread, like the two halves of
+  // a bidirectional search, take workspaces with different indices.
+  static TraversalWorkspace& get_thread_workspace(int index = 0);
+
+  // Forgets the previous search and makes room for |vertices_count| ids.
+  void reset(int vertices_count);
+
+  bool is_reached(const VertexId& vertex_id) const {
+    return reached_.test(vertex_id);
+  }
+  // First unreached vertex at or after the given one, or the vertices count.
+  VertexId find_next_unreached(const VertexId& vertex_id) const {
+    return reached_.find_next_unset(vertex_id, vertices_count_);
+  }
+
+  // Marks the vertex reached and appends it to the queue.
+  void reach(const VertexId& vertex_id,
+             const VertexId& parent_vertex_id,
+             int distance) {
+    reached_.set(vertex_id);
+    parent_vertex_ids_[vertex_id] = parent_vertex_id;
+    distances_[vertex_id] = distance;
+    vertices_queue_.push_back(vertex_id);
+  }
+
+  // Gives an already reached vertex a shorter way in.
+  void improve(const VertexId& vertex_id,
+               const VertexId& parent_vertex_id,
+               int distance) {
+    parent_vertex_ids_[vertex_id] = parent_vertex_id;
+    distances_[vertex_id] = distance;
+  }
+
+  VertexId get_parent_vertex_id(const VertexId& vertex_id) const {
+    return parent_vertex_ids_[vertex_id];
+  }
+  int get_distance(const VertexId& vertex_id) const {
+    return distances_[vertex_id];
+  }
+
+  // Vertices in the order they were reached.
+  const std::vector<VertexId>& get_vertices_queue() const {
+    return vertices_queue_;
+  }
+
+  // Remembers the queued vertices in [begin, end) as the frontier, so that
+  // membership tests do not need their distances.
+  void set_frontier(int begin, int end);
+  bool is_in_frontier(const VertexId& vertex_id) const {
+    return frontier_.test(vertex_id);
+  }
+
+  // Returns false if the vertex was already marked.
+  bool mark_destination(const VertexId& vertex_id) {
+    if (destinations_.test(vertex_id))
+      return false;
+    destinations_.set(vertex_id);
+    return true;
+  }
+  bool is_destination(const VertexId& vertex_id) const {
+    return destinations_.test(vertex_id);
+  }
+
+ private:
+  StampedBitset reached_;
+  StampedBitset destinations_;
+  StampedBitset frontier_;
+  int vertices_count_ = 0;
+  std::vector<VertexId> parent_vertex_ids_;
+  std::vector<int> distances_;
+  std::vector<VertexId> vertices_queue_;
+};
+
+}  // namespace uni_cpp_practice